@@ -0,0 +1,156 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+// Measures lookups in large sorted tables, which are dominated by cache misses rather than comparisons,
+// and building sorted vectors one value at a time compared to in bulk.
+
+#include "harness.hpp"
+#include <ctoolhu/container/eytzinger_array.hpp>
+#include <ctoolhu/container/flat_set.hpp>
+#include <ctoolhu/std_ext.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+	using namespace Ctoolhu;
+
+	constexpr std::uint64_t lookups{2'000'000};
+	constexpr std::size_t sizes[] = {4096, 65536, 1'048'576};
+
+	//sorted values 0, 2, 4, ... so that odd keys are missing
+	std::vector<int> EvenValues(std::size_t size)
+	{
+		std::vector<int> values(size);
+		for (std::size_t i{0}; i < size; ++i)
+			values[i] = static_cast<int>(2 * i);
+
+		return values;
+	}
+
+	//random keys in the range of the values, half of them missing; many, so that they don't stay cached
+	std::vector<int> Keys(std::size_t size)
+	{
+		std::mt19937 engine{size};
+		std::uniform_int_distribution<int> key{0, static_cast<int>(2 * size)};
+		std::vector<int> keys(lookups);
+		for (auto &k : keys)
+			k = key(engine);
+
+		return keys;
+	}
+
+	template <class Table, class Search>
+	void MeasureLookups(Benchmark::Context &context, const char *name, Search search)
+	{
+		for (auto size : sizes) {
+			Table const table{EvenValues(size)};
+			auto const keys = Keys(size);
+			std::uint64_t found{0};
+			auto const elapsed = Benchmark::Measure([&] {
+				for (auto key : keys)
+					found += search(table, key);
+			});
+			Benchmark::Consume(found);
+			context.Report({name, Benchmark::Param("size", size), lookups, elapsed});
+		}
+	}
+
+	bool const lowerBound = Benchmark::Register("container/sorted_lookup/std_lower_bound", [](Benchmark::Context &context) {
+		MeasureLookups<std::vector<int>>(context, "container/sorted_lookup/std_lower_bound", [](auto const &values, int key) {
+			auto const it = std::lower_bound(values.begin(), values.end(), key);
+			return it != values.end() && *it == key;
+		});
+	});
+
+	bool const binaryFind = Benchmark::Register("container/sorted_lookup/binary_find", [](Benchmark::Context &context) {
+		MeasureLookups<std::vector<int>>(context, "container/sorted_lookup/binary_find", [](auto const &values, int key) { return std_ext::binary_find(values, key) != values.end(); });
+	});
+
+	bool const eytzinger = Benchmark::Register("container/sorted_lookup/eytzinger", [](Benchmark::Context &context) {
+		MeasureLookups<Container::EytzingerArray<int>>(context, "container/sorted_lookup/eytzinger", [](auto const &table, int key) { return table.find(key) != table.end(); });
+	});
+
+	bool const eytzingerBatch = Benchmark::Register("container/sorted_lookup/eytzinger_batch", [](Benchmark::Context &context) {
+		for (auto size : sizes) {
+			Container::EytzingerArray<int> const table{EvenValues(size)};
+			auto const keys = Keys(size);
+			std::vector<const int *> results(keys.size());
+			std::uint64_t found{0};
+			auto const elapsed = Benchmark::Measure([&] {
+				table.find(keys, results.begin());
+				for (auto result : results)
+					found += result != table.end();
+			});
+			Benchmark::Consume(found);
+			context.Report({"container/sorted_lookup/eytzinger_batch", Benchmark::Param("size", size), lookups, elapsed});
+		}
+	});
+
+	constexpr std::size_t buildSizes[] = {1000, 10'000, 100'000};
+
+	//random values, a tenth of them repeated
+	std::vector<int> RandomValues(std::size_t size)
+	{
+		std::mt19937 engine{size};
+		std::uniform_int_distribution<int> value{0, static_cast<int>(size - size / 10)};
+		std::vector<int> values(size);
+		for (auto &v : values)
+			v = value(engine);
+
+		return values;
+	}
+
+	template <class Build>
+	void MeasureBuilds(Benchmark::Context &context, const char *name, Build build)
+	{
+		for (auto size : buildSizes) {
+			auto const values = RandomValues(size);
+			auto const count = std::max<std::uint64_t>(1'000'000 / size, 1);
+			std::uint64_t built{0};
+			auto const elapsed = Benchmark::Measure([&] {
+				for (std::uint64_t i{0}; i < count; ++i)
+					built += build(values);
+			});
+			Benchmark::Consume(built);
+			context.Report({name, Benchmark::Param("size", size), count * size, elapsed});
+		}
+	}
+
+	//deduplicated by a lookup before each insertion, as the pattern is usually written
+	bool const insertSorted = Benchmark::Register("container/sorted_build/insert_sorted", [](Benchmark::Context &context) {
+		MeasureBuilds(context, "container/sorted_build/insert_sorted", [](std::vector<int> const &values) {
+			std::vector<int> sorted;
+			for (auto v : values) {
+				if (!std_ext::binary_search(sorted, v))
+					std_ext::insert_sorted(sorted, v);
+			}
+			return sorted.size();
+		});
+	});
+
+	bool const flatSetInsert = Benchmark::Register("container/sorted_build/flat_set_insert", [](Benchmark::Context &context) {
+		MeasureBuilds(context, "container/sorted_build/flat_set_insert", [](std::vector<int> const &values) {
+			std_ext::flat_set<int> set;
+			for (auto v : values)
+				set.insert(v);
+
+			return set.size();
+		});
+	});
+
+	//inserted in chunks, so that each merges into the values already present
+	bool const flatSetInsertRange = Benchmark::Register("container/sorted_build/flat_set_insert_range", [](Benchmark::Context &context) {
+		MeasureBuilds(context, "container/sorted_build/flat_set_insert_range", [](std::vector<int> const &values) {
+			std_ext::flat_set<int> set;
+			auto const chunk = values.size() / 4;
+			for (std::size_t first{0}; first < values.size(); first += chunk)
+				set.insert_range(std::ranges::subrange(values.begin() + first, values.begin() + std::min(first + chunk, values.size())));
+
+			return set.size();
+		});
+	});
+
+} //ns
@@ -0,0 +1,86 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+// Measures firing events to a growing number of subscribers, and capturing and replaying them.
+
+#include "harness.hpp"
+#include <ctoolhu/event/firer.hpp>
+#include <ctoolhu/event/free_subscriber.hpp>
+#include <ctoolhu/event/recorder.hpp>
+#include <ctoolhu/event/replayer.hpp>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace {
+
+	using namespace Ctoolhu;
+
+	struct BenchmarkEvent {
+		std::uint64_t value;
+	};
+
+	bool const eventFire = Benchmark::Register("event/fire", [](Benchmark::Context &context) {
+		constexpr std::uint64_t fires{200'000};
+		for (unsigned subscribers : {0u, 1u, 4u, 16u, 64u}) {
+			Event::FreeSubscriber subscriber;
+			std::atomic<std::uint64_t> sum{0};
+			for (unsigned i{0}; i < subscribers; ++i)
+				subscriber.Subscribe<BenchmarkEvent>([&sum](BenchmarkEvent *e) { sum.fetch_add(e->value, std::memory_order_relaxed); });
+
+			for (auto threads : {1u, context.MaxThreads()}) {
+				auto const perThread = fires / threads;
+				auto const elapsed = Benchmark::MeasureThreads(threads, [perThread](unsigned) {
+					for (std::uint64_t i{0}; i < perThread; ++i)
+						Event::Fire(BenchmarkEvent{i});
+				});
+				context.Report({"event/fire", Benchmark::Param("subscribers", subscribers) + ',' + Benchmark::Param("threads", threads), perThread * threads, elapsed});
+				if (context.MaxThreads() == 1)
+					break;
+			}
+			Benchmark::Consume(sum);
+		}
+	});
+
+	//the same events are captured on every run, so the replay measures the same log
+	constexpr std::uint64_t captured{1'000'000};
+
+	std::string CaptureFile()
+	{
+		return (std::filesystem::temp_directory_path() / "ctoolhu_benchmark_capture.bin").string();
+	}
+
+	//includes writing out the buffered events when the recorder is closed
+	bool const eventRecord = Benchmark::Register("event/record", [](Benchmark::Context &context) {
+		auto const elapsed = Benchmark::Measure([] {
+			Event::Recorder<BenchmarkEvent> recorder{CaptureFile()};
+			for (std::uint64_t i{0}; i < captured; ++i)
+				Event::Fire(BenchmarkEvent{i});
+
+			recorder.Close();
+		});
+		context.Report({"event/record", Benchmark::Param("events", captured), captured, elapsed});
+		std::filesystem::remove(CaptureFile());
+	});
+
+	bool const eventReplay = Benchmark::Register("event/replay", [](Benchmark::Context &context) {
+		{
+			Event::Recorder<BenchmarkEvent> recorder{CaptureFile()};
+			for (std::uint64_t i{0}; i < captured; ++i)
+				Event::Fire(BenchmarkEvent{i});
+		}
+		Event::FreeSubscriber subscriber;
+		std::uint64_t sum{0};
+		subscriber.Subscribe<BenchmarkEvent>([&sum](BenchmarkEvent *e) { sum += e->value; });
+		Event::Replayer<BenchmarkEvent> const replayer{CaptureFile()};
+		std::uint64_t replayed{0};
+		auto const elapsed = Benchmark::Measure([&] {
+			replayed = replayer.Replay();
+		});
+		Benchmark::Consume(sum);
+		context.Report({"event/replay", Benchmark::Param("events", captured), replayed, elapsed});
+		std::filesystem::remove(CaptureFile());
+	});
+
+} //ns
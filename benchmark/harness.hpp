@@ -0,0 +1,197 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_benchmark_harness_included_
+#define _ctoolhu_benchmark_harness_included_
+
+#include <ctoolhu/time/histogram.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <latch>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//Minimal harness of the micro-benchmarks.
+//Each source file registers its benchmarks, which report one Result per parameter combination, e.g.
+//
+//	static bool const registered = Benchmark::Register("thread/pool_submit", [](Benchmark::Context &context) {
+//		for (auto threads : context.ThreadCounts())
+//			context.Report({"thread/pool_submit", Benchmark::Param("threads", threads), jobs, elapsed});
+//	});
+//
+namespace Ctoolhu::Benchmark {
+
+	using seconds_t = std::chrono::duration<double>;
+
+	//outcome of one benchmark with given parameters
+	struct Result {
+		std::string name;		//e.g. "thread/pool_submit"
+		std::string params;		//e.g. "threads=4"
+		std::uint64_t operations;
+		seconds_t elapsed;
+		std::optional<Time::LatencySnapshot> latency{}; //per operation, where measured
+	};
+
+	enum class Format { Table, Csv, Json };
+
+	//receives the results of the benchmarks and writes them in the requested format
+	class Context {
+
+	  public:
+
+		Context(Format format, unsigned maxThreads)
+			: _format{format}, _maxThreads{std::max(maxThreads, 1u)} {}
+
+		Context(const Context &) = delete;
+		Context &operator=(const Context &) = delete;
+
+		~Context()
+		{
+			if (_format == Format::Json)
+				std::printf(_first ? "[]\n" : "\n]\n");
+		}
+
+		//1, 2, 4, ... up to the maximum thread count (inclusive)
+		std::vector<unsigned> ThreadCounts() const
+		{
+			std::vector<unsigned> counts;
+			for (unsigned n{1}; n < _maxThreads; n *= 2)
+				counts.push_back(n);
+
+			counts.push_back(_maxThreads);
+			return counts;
+		}
+
+		unsigned MaxThreads() const noexcept { return _maxThreads; }
+
+		void Report(const Result &result)
+		{
+			auto const seconds = result.elapsed.count();
+			auto const perSecond = seconds > 0 ? result.operations / seconds : 0.0;
+			auto const nsPerOperation = result.operations ? seconds * 1e9 / result.operations : 0.0;
+			auto const percentile = [&result](double percent) -> long long {
+				return result.latency ? result.latency->Percentile(percent).count() : -1;
+			};
+			switch (_format) {
+				case Format::Table:
+					if (_first)
+						std::printf("%-32s %-40s %12s %14s %12s %12s %12s\n", "benchmark", "params", "operations", "ops/s", "ns/op", "p50 ns", "p99 ns");
+
+					std::printf("%-32s %-40s %12llu %14.0f %12.2f", result.name.c_str(), result.params.c_str(),
+						static_cast<unsigned long long>(result.operations), perSecond, nsPerOperation);
+					if (result.latency)
+						std::printf(" %12lld %12lld", percentile(50), percentile(99));
+
+					std::printf("\n");
+					break;
+
+				case Format::Csv:
+					if (_first)
+						std::printf("name,params,operations,seconds,ops_per_second,ns_per_op,p50_ns,p99_ns,p999_ns,max_ns\n");
+
+					std::printf("%s,\"%s\",%llu,%.9f,%.3f,%.3f,%lld,%lld,%lld,%lld\n", result.name.c_str(), result.params.c_str(),
+						static_cast<unsigned long long>(result.operations), seconds, perSecond, nsPerOperation,
+						percentile(50), percentile(99), percentile(99.9), result.latency ? static_cast<long long>(result.latency->Max().count()) : -1);
+					break;
+
+				case Format::Json:
+					std::printf("%s\n  {\"name\": \"%s\", \"params\": \"%s\", \"operations\": %llu, \"seconds\": %.9f, \"ops_per_second\": %.3f, \"ns_per_op\": %.3f",
+						_first ? "[" : ",", result.name.c_str(), result.params.c_str(),
+						static_cast<unsigned long long>(result.operations), seconds, perSecond, nsPerOperation);
+					if (result.latency)
+						std::printf(", \"latency_ns\": {\"p50\": %lld, \"p99\": %lld, \"p999\": %lld, \"max\": %lld}",
+							percentile(50), percentile(99), percentile(99.9), static_cast<long long>(result.latency->Max().count()));
+
+					std::printf("}");
+					break;
+			}
+			std::fflush(stdout);
+			_first = false;
+		}
+
+	  private:
+
+		Format const _format;
+		unsigned const _maxThreads;
+		bool _first{true};
+	};
+
+	using benchmark_t = std::function<void (Context &)>;
+
+	inline std::vector<std::pair<std::string, benchmark_t>> &Registry()
+	{
+		static std::vector<std::pair<std::string, benchmark_t>> benchmarks;
+		return benchmarks;
+	}
+
+	//adds a benchmark to be run by the main program, meant for initializing a static variable
+	inline bool Register(std::string name, benchmark_t benchmark)
+	{
+		Registry().emplace_back(std::move(name), std::move(benchmark));
+		return true;
+	}
+
+	template <class Value>
+	std::string Param(const char *name, const Value &value)
+	{
+		if constexpr (std::is_convertible_v<Value, std::string>)
+			return std::string{name} + '=' + std::string{value};
+		else
+			return std::string{name} + '=' + std::to_string(value);
+	}
+
+	namespace Private {
+
+		inline volatile std::uint64_t sink;
+
+	} //ns Private
+
+	//keeps the compiler from optimizing away the computation of the value
+	inline void Consume(std::uint64_t value) noexcept
+	{
+		Private::sink = value;
+	}
+
+	//returns how long the body takes
+	template <class Body>
+	seconds_t Measure(Body &&body)
+	{
+		auto const start = std::chrono::steady_clock::now();
+		body();
+		return std::chrono::steady_clock::now() - start;
+	}
+
+	//Runs body(threadIndex) in given number of threads released at once.
+	//Returns the time from their release until the last one finishes.
+	template <class Body>
+	seconds_t MeasureThreads(unsigned threads, Body body)
+	{
+		std::latch ready{threads + 1}, go{1};
+		std::vector<std::thread> workers;
+		workers.reserve(threads);
+		for (unsigned i{0}; i < threads; ++i)
+			workers.emplace_back([&, i] {
+				ready.count_down();
+				go.wait();
+				body(i);
+			});
+
+		ready.arrive_and_wait();
+		auto const start = std::chrono::steady_clock::now();
+		go.count_down();
+		for (auto &worker : workers)
+			worker.join();
+
+		return std::chrono::steady_clock::now() - start;
+	}
+
+} //ns Ctoolhu::Benchmark
+
+#endif //file guard
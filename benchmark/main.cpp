@@ -0,0 +1,51 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+// Runs the registered micro-benchmarks of Ctoolhu components.
+//
+//	ctoolhu_benchmark [--format=table|csv|json] [--filter=<substring of benchmark name>] [--threads=<max threads>]
+//
+// The results go to the standard output, so that they can be redirected to a file and tracked over time.
+// Latency percentiles are reported only by some benchmarks (-1 in the csv output elsewhere).
+
+#include "harness.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <thread>
+
+int main(int argc, char *argv[])
+{
+	using namespace Ctoolhu::Benchmark;
+
+	auto format = Format::Table;
+	std::string_view filter;
+	auto maxThreads = std::thread::hardware_concurrency();
+	for (int i{1}; i < argc; ++i) {
+		std::string_view const arg{argv[i]};
+		if (arg == "--format=table")
+			format = Format::Table;
+		else if (arg == "--format=csv")
+			format = Format::Csv;
+		else if (arg == "--format=json")
+			format = Format::Json;
+		else if (arg.starts_with("--filter="))
+			filter = arg.substr(9);
+		else if (arg.starts_with("--threads="))
+			maxThreads = static_cast<unsigned>(std::strtoul(argv[i] + 10, nullptr, 10));
+		else {
+			std::fprintf(stderr, "usage: %s [--format=table|csv|json] [--filter=<name part>] [--threads=<max threads>]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	//registration order across the source files is unspecified
+	std::ranges::stable_sort(Registry(), {}, [](auto const &entry) -> const std::string & { return entry.first; });
+	Context context{format, maxThreads};
+	for (auto const &[name, benchmark] : Registry()) {
+		if (name.find(filter) != std::string::npos)
+			benchmark(context);
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,75 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+// Measures creating and destroying objects by the object pools compared to plain new and delete (malloc).
+
+#include "harness.hpp"
+#include <ctoolhu/memory/concurrent_object_pool.hpp>
+#include <ctoolhu/memory/object_pool.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace {
+
+	using namespace Ctoolhu;
+
+	struct Object {
+		explicit Object(std::uint64_t v) : value{v} {}
+
+		std::uint64_t value;
+		std::uint64_t payload[7];
+	};
+
+	constexpr std::uint64_t objects{2'000'000};
+	constexpr std::size_t live{1024}; //objects created before they are destroyed in a batch
+
+	//creates and destroys objects in batches, so that the allocator sees both reuse and growth
+	template <class Make>
+	void Churn(std::uint64_t count, Make make)
+	{
+		std::vector<decltype(make(0))> batch;
+		batch.reserve(live);
+		std::uint64_t sum{0};
+		for (std::uint64_t i{0}; i < count; ++i) {
+			batch.push_back(make(i));
+			if (batch.size() == live) {
+				for (auto const &object : batch)
+					sum += object->value;
+
+				batch.clear();
+			}
+		}
+		Benchmark::Consume(sum);
+	}
+
+	bool const objectPool = Benchmark::Register("memory/object_pool", [](Benchmark::Context &context) {
+		Memory::ObjectPool<Object> pool;
+		auto const elapsed = Benchmark::Measure([&pool] {
+			Churn(objects, [&pool](std::uint64_t i) { return pool.make_unique(i); });
+		});
+		context.Report({"memory/object_pool", Benchmark::Param("threads", 1), objects, elapsed});
+	});
+
+	bool const concurrentObjectPool = Benchmark::Register("memory/concurrent_object_pool", [](Benchmark::Context &context) {
+		for (auto threads : context.ThreadCounts()) {
+			Memory::ConcurrentObjectPool<Object> pool;
+			auto const perThread = objects / threads;
+			auto const elapsed = Benchmark::MeasureThreads(threads, [&pool, perThread](unsigned) {
+				Churn(perThread, [&pool](std::uint64_t i) { return pool.make_unique(i); });
+			});
+			context.Report({"memory/concurrent_object_pool", Benchmark::Param("threads", threads), perThread * threads, elapsed});
+		}
+	});
+
+	bool const newDelete = Benchmark::Register("memory/new_delete", [](Benchmark::Context &context) {
+		for (auto threads : context.ThreadCounts()) {
+			auto const perThread = objects / threads;
+			auto const elapsed = Benchmark::MeasureThreads(threads, [perThread](unsigned) {
+				Churn(perThread, [](std::uint64_t i) { return std::make_unique<Object>(i); });
+			});
+			context.Report({"memory/new_delete", Benchmark::Param("threads", threads), perThread * threads, elapsed});
+		}
+	});
+
+} //ns
@@ -0,0 +1,102 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+// Measures drawing random numbers by the generators and selecting random members of containers.
+
+#include "harness.hpp"
+#include <ctoolhu/random/engines.hpp>
+#include <ctoolhu/random/generator.hpp>
+#include <ctoolhu/random/selector.hpp>
+#include <ctoolhu/random/weighted_selector.hpp>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+	using namespace Ctoolhu;
+
+	constexpr std::uint64_t draws{10'000'000};
+
+	//dice rolls by every thread from its own engine
+	template <class Engine>
+	void MeasureGenerator(Benchmark::Context &context, const char *name)
+	{
+		for (auto threads : context.ThreadCounts()) {
+			auto const perThread = draws / threads;
+			auto const elapsed = Benchmark::MeasureThreads(threads, [perThread](unsigned) {
+				Random::Generator<std::uniform_int_distribution<>, int, Engine> roll{1, 6};
+				std::uint64_t sum{0};
+				for (std::uint64_t i{0}; i < perThread; ++i)
+					sum += roll();
+
+				Benchmark::Consume(sum);
+			});
+			context.Report({"random/generator", Benchmark::Param("engine", name) + ',' + Benchmark::Param("threads", threads), perThread * threads, elapsed});
+		}
+	}
+
+	bool const generator = Benchmark::Register("random/generator", [](Benchmark::Context &context) {
+		MeasureGenerator<std::mt19937>(context, "std::mt19937");
+		MeasureGenerator<Random::Xoshiro256StarStar>(context, "Xoshiro256StarStar");
+	});
+
+	bool const fill = Benchmark::Register("random/fill", [](Benchmark::Context &context) {
+		std::vector<int> buffer(draws);
+		Random::Generator<std::uniform_int_distribution<>> roll{1, 6};
+		auto const elapsed = Benchmark::Measure([&] {
+			roll.fill(buffer);
+		});
+		Benchmark::Consume(static_cast<std::uint64_t>(buffer.back()));
+		context.Report({"random/fill", Benchmark::Param("type", "int"), draws, elapsed});
+	});
+
+	bool const select = Benchmark::Register("random/select", [](Benchmark::Context &context) {
+		for (std::size_t size : {16u, 1024u, 65536u}) {
+			std::vector<std::uint64_t> values(size);
+			std::iota(values.begin(), values.end(), 0);
+			Random::Selector selector;
+			std::uint64_t sum{0};
+			auto const elapsed = Benchmark::Measure([&] {
+				for (std::uint64_t i{0}; i < draws; ++i)
+					sum += selector(values);
+			});
+			Benchmark::Consume(sum);
+			context.Report({"random/select", Benchmark::Param("size", size), draws, elapsed});
+		}
+	});
+
+	bool const selectK = Benchmark::Register("random/select_k", [](Benchmark::Context &context) {
+		constexpr std::size_t size{65536};
+		std::vector<std::uint64_t> values(size);
+		std::iota(values.begin(), values.end(), 0);
+		Random::Selector selector;
+		for (std::size_t k : {8u, 64u, 1024u}) {
+			auto const selections = draws / 10 / k;
+			std::uint64_t sum{0};
+			auto const elapsed = Benchmark::Measure([&] {
+				for (std::uint64_t i{0}; i < selections; ++i)
+					sum += *selector.SelectK(values, k).front();
+			});
+			Benchmark::Consume(sum);
+			context.Report({"random/select_k", Benchmark::Param("size", size) + ',' + Benchmark::Param("k", k), selections, elapsed});
+		}
+	});
+
+	bool const weightedSelect = Benchmark::Register("random/weighted_select", [](Benchmark::Context &context) {
+		for (std::size_t size : {16u, 1024u, 65536u}) {
+			std::vector<double> weights(size);
+			std::iota(weights.begin(), weights.end(), 1.0);
+			Random::WeightedSelector selector{weights};
+			std::uint64_t sum{0};
+			auto const elapsed = Benchmark::Measure([&] {
+				for (std::uint64_t i{0}; i < draws; ++i)
+					sum += selector();
+			});
+			Benchmark::Consume(sum);
+			context.Report({"random/weighted_select", Benchmark::Param("size", size), draws, elapsed});
+		}
+	});
+
+} //ns
@@ -0,0 +1,38 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+// Measures raw draws per second of the random engines usable with Ctoolhu::Random.
+
+#include "harness.hpp"
+#include <ctoolhu/random/engines.hpp>
+#include <ctoolhu/random/philox.hpp>
+#include <cstdint>
+#include <random>
+
+namespace {
+
+	constexpr std::uint64_t draws{20'000'000};
+
+	template <class Engine>
+	void Measure(Ctoolhu::Benchmark::Context &context, const char *name)
+	{
+		Engine engine;
+		std::uint64_t sink{0};
+		auto const elapsed = Ctoolhu::Benchmark::Measure([&] {
+			for (std::uint64_t i{0}; i < draws; ++i)
+				sink += engine();
+		});
+		Ctoolhu::Benchmark::Consume(sink);
+		context.Report({"random/engine", Ctoolhu::Benchmark::Param("engine", name), draws, elapsed});
+	}
+
+	bool const engines = Ctoolhu::Benchmark::Register("random/engine", [](Ctoolhu::Benchmark::Context &context) {
+		Measure<std::mt19937>(context, "std::mt19937");
+		Measure<std::mt19937_64>(context, "std::mt19937_64");
+		Measure<Ctoolhu::Random::SplitMix64>(context, "SplitMix64");
+		Measure<Ctoolhu::Random::Xoshiro256StarStar>(context, "Xoshiro256StarStar");
+		Measure<Ctoolhu::Random::Pcg64>(context, "Pcg64");
+		Measure<Ctoolhu::Random::Philox4x32>(context, "Philox4x32");
+	});
+
+} //ns
@@ -0,0 +1,96 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+// Measures the searches of std_ext on containers of growing size.
+
+#include "harness.hpp"
+#include <ctoolhu/std_ext.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+	using namespace Ctoolhu;
+
+	constexpr std::uint64_t lookups{1'000'000};
+	constexpr std::size_t sizes[] = {16, 100, 256, 4096, 65536};
+
+	//sorted values 0, 2, 4, ... so that odd keys are missing
+	std::vector<int> EvenValues(std::size_t size)
+	{
+		std::vector<int> values(size);
+		for (std::size_t i{0}; i < size; ++i)
+			values[i] = static_cast<int>(2 * i);
+
+		return values;
+	}
+
+	//random keys in the range of the values, half of them missing
+	std::vector<int> Keys(std::size_t size, std::size_t count)
+	{
+		std::mt19937 engine{size};
+		std::uniform_int_distribution<int> key{0, static_cast<int>(2 * size)};
+		std::vector<int> keys(count);
+		for (auto &k : keys)
+			k = key(engine);
+
+		return keys;
+	}
+
+	template <class Search>
+	void MeasureLookups(Benchmark::Context &context, const char *name, Search search)
+	{
+		for (auto size : sizes) {
+			auto const values = EvenValues(size);
+			auto const keys = Keys(size, 4096);
+			auto const count = std::max<std::uint64_t>(lookups / size, 4096);
+			std::uint64_t found{0};
+			auto const elapsed = Benchmark::Measure([&] {
+				for (std::uint64_t i{0}; i < count; ++i)
+					found += search(values, keys[i % keys.size()]);
+			});
+			Benchmark::Consume(found);
+			context.Report({name, Benchmark::Param("size", size), count, elapsed});
+		}
+	}
+
+	bool const contains = Benchmark::Register("std_ext/contains", [](Benchmark::Context &context) {
+		MeasureLookups(context, "std_ext/contains", [](auto const &values, int key) { return std_ext::contains(values, key); });
+	});
+
+	bool const countSorted = Benchmark::Register("std_ext/count_sorted", [](Benchmark::Context &context) {
+		MeasureLookups(context, "std_ext/count_sorted", [](auto const &values, int key) { return std_ext::count_sorted(values, key); });
+	});
+
+	bool const binarySearch = Benchmark::Register("std_ext/binary_search", [](Benchmark::Context &context) {
+		MeasureLookups(context, "std_ext/binary_search", [](auto const &values, int key) { return std_ext::binary_search(values, key); });
+	});
+
+	bool const binaryFind = Benchmark::Register("std_ext/binary_find", [](Benchmark::Context &context) {
+		MeasureLookups(context, "std_ext/binary_find", [](auto const &values, int key) { return std_ext::binary_find(values, key) != values.end(); });
+	});
+
+	//needles all missing from the haystack, which is the worst case
+	bool const containsAny = Benchmark::Register("std_ext/contains_any", [](Benchmark::Context &context) {
+		for (auto size : sizes) {
+			auto const haystack = EvenValues(size);
+			for (std::size_t needleCount : {1u, 16u, 256u}) {
+				std::vector<int> needles(needleCount);
+				for (std::size_t i{0}; i < needleCount; ++i)
+					needles[i] = static_cast<int>(2 * i + 1);
+
+				auto const count = std::max<std::uint64_t>(lookups / size / needleCount, 16);
+				std::uint64_t found{0};
+				auto const elapsed = Benchmark::Measure([&] {
+					for (std::uint64_t i{0}; i < count; ++i)
+						found += std_ext::contains_any(haystack, needles);
+				});
+				Benchmark::Consume(found);
+				context.Report({"std_ext/contains_any", Benchmark::Param("haystack", size) + ',' + Benchmark::Param("needles", needleCount), count, elapsed});
+			}
+		}
+	});
+
+} //ns
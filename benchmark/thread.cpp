@@ -0,0 +1,84 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+// Measures the thread pool, the thread-safe queue and the locking proxy under contention.
+
+#include "harness.hpp"
+#include <ctoolhu/thread/lockable.hpp>
+#include <ctoolhu/thread/pool.hpp>
+#include <ctoolhu/thread/proxy.hpp>
+#include <ctoolhu/thread/queue.hpp>
+#include <ctoolhu/time/histogram.hpp>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+	using namespace Ctoolhu;
+
+	//throughput of submitting empty jobs and their latency from submission to execution
+	bool const poolSubmit = Benchmark::Register("thread/pool_submit", [](Benchmark::Context &context) {
+		constexpr std::uint64_t jobs{100'000};
+		for (auto threads : context.ThreadCounts()) {
+			Thread::Pool pool{threads};
+			Time::LatencyHistogram latency;
+			std::vector<std::future<void>> futures;
+			futures.reserve(jobs);
+			auto const elapsed = Benchmark::Measure([&] {
+				for (std::uint64_t i{0}; i < jobs; ++i)
+					futures.push_back(pool.submit([&latency, submitted = std::chrono::steady_clock::now()] {
+						latency.Record(std::chrono::steady_clock::now() - submitted);
+					}));
+
+				for (auto &future : futures)
+					future.get();
+			});
+			context.Report({"thread/pool_submit", Benchmark::Param("threads", threads), jobs, elapsed, latency.Snapshot()});
+		}
+	});
+
+	//as many producers as consumers passing items through one queue
+	bool const queuePushPop = Benchmark::Register("thread/queue_push_pop", [](Benchmark::Context &context) {
+		constexpr std::uint64_t items{400'000};
+		for (auto pairs : context.ThreadCounts()) {
+			Thread::Queue<std::uint64_t> queue;
+			auto const perThread = items / pairs;
+			auto const elapsed = Benchmark::MeasureThreads(2 * pairs, [&](unsigned index) {
+				if (index < pairs) {
+					for (std::uint64_t i{0}; i < perThread; ++i)
+						queue.push(i);
+				}
+				else {
+					std::uint64_t item, sum{0};
+					for (std::uint64_t i{0}; i < perThread && queue.waitPop(item); ++i)
+						sum += item;
+
+					Benchmark::Consume(sum);
+				}
+			});
+			context.Report({"thread/queue_push_pop", Benchmark::Param("producers", pairs) + ',' + Benchmark::Param("consumers", pairs), perThread * pairs, elapsed});
+		}
+	});
+
+	struct Counter : Thread::Lockable<std::mutex> {
+		std::uint64_t value{0};
+	};
+
+	//acquisitions of one object through the locking proxy by all threads
+	bool const proxyLock = Benchmark::Register("thread/locking_proxy", [](Benchmark::Context &context) {
+		constexpr std::uint64_t acquisitions{2'000'000};
+		for (auto threads : context.ThreadCounts()) {
+			Counter counter;
+			auto const perThread = acquisitions / threads;
+			auto const elapsed = Benchmark::MeasureThreads(threads, [&](unsigned) {
+				for (std::uint64_t i{0}; i < perThread; ++i)
+					++Thread::LockingProxy<Counter>{&counter}->value;
+			});
+			context.Report({"thread/locking_proxy", Benchmark::Param("threads", threads), perThread * threads, elapsed});
+		}
+	});
+
+} //ns
@@ -0,0 +1,225 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_container_eytzinger_array_included_
+#define _ctoolhu_container_eytzinger_array_included_
+
+#include "search.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <ranges>
+#include <vector>
+
+namespace Ctoolhu::Container {
+
+	namespace Private {
+
+		//allocator of memory starting at a cache line boundary
+		template <class T>
+		struct CacheLineAllocator {
+
+			using value_type = T;
+
+			static constexpr std::size_t alignment{std::max<std::size_t>(64, alignof(T))};
+
+			CacheLineAllocator() = default;
+
+			template <class U>
+			CacheLineAllocator(const CacheLineAllocator<U> &) noexcept {}
+
+			T *allocate(std::size_t n)
+			{
+				return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{alignment}));
+			}
+
+			void deallocate(T *ptr, std::size_t) noexcept
+			{
+				::operator delete(ptr, std::align_val_t{alignment});
+			}
+
+			template <class U>
+			bool operator==(const CacheLineAllocator<U> &) const noexcept { return true; }
+		};
+
+	} //ns Private
+
+	//Immutable sorted lookup table for large sets of values searched many times, e.g. a million-element id table.
+	//The values are stored in Eytzinger (breadth-first) order of an implicit binary search tree: the first levels share
+	//a few cache lines, the search is branchless and the cache line needed four levels down is prefetched on the way.
+	//Iteration is in the storage order, not the sorted one. Duplicate values are kept, e.g.
+	//
+	//	EytzingerArray<int> table{values};
+	//	if (auto it = table.find(key); it != table.end()) ...
+	//	table.find(keys, out); //batch lookup, interleaving the searches
+	//
+	template <class T, class Compare = std::less<>>
+	class EytzingerArray {
+
+	  public:
+
+		using value_type = T;
+		using size_type = std::size_t;
+		using const_iterator = const T *;
+		using iterator = const_iterator;
+
+		EytzingerArray() = default;
+
+		template <std::ranges::input_range Values>
+		explicit EytzingerArray(const Values &values, Compare comp = {})
+			: _comp{comp}
+		{
+			std::vector<T> sorted(std::ranges::begin(values), std::ranges::end(values));
+			std::sort(sorted.begin(), sorted.end(), _comp);
+			if (sorted.empty())
+				return;
+
+			//The nodes are numbered from 1, the unused first slot keeps the arithmetic simple and aligns the nodes,
+			//so that the 16 descendants of a node four levels down (of 4-byte values) start a cache line and fill it.
+			_nodes.reserve(sorted.size() + 1);
+			_nodes.assign(sorted.size() + 1, sorted.front());
+			std::size_t next{0};
+			layOut(sorted, next, 1);
+		}
+
+		size_type size() const noexcept { return _nodes.empty() ? 0 : _nodes.size() - 1; }
+		bool empty() const noexcept { return _nodes.size() <= 1; }
+
+		const_iterator begin() const noexcept { return _nodes.empty() ? nullptr : _nodes.data() + 1; }
+		const_iterator end() const noexcept { return _nodes.empty() ? nullptr : _nodes.data() + _nodes.size(); }
+
+		//first value not ordered before the key (in sorted order), or end
+		template <class Key>
+		const_iterator lower_bound(const Key &key) const
+		{
+			return at(lowerBound(key));
+		}
+
+		//a value equal to the key, or end (like std_ext::binary_find)
+		template <class Key>
+		const_iterator find(const Key &key) const
+		{
+			auto const node = lowerBound(key);
+			return node && !_comp(key, _nodes[node]) ? at(node) : end();
+		}
+
+		template <class Key>
+		bool contains(const Key &key) const
+		{
+			return find(key) != end();
+		}
+
+		//number of values equal to the key (like std_ext::count_sorted)
+		template <class Key>
+		size_type count(const Key &key) const
+		{
+			size_type n{0};
+			for (auto node = lowerBound(key); node && !_comp(key, _nodes[node]); node = successor(node))
+				++n;
+
+			return n;
+		}
+
+		//Looks up all the keys, writing an iterator for each like find does.
+		//The searches advance a group at a time level by level, so that the memory latency of one is hidden by the others.
+		template <std::ranges::random_access_range Keys, std::output_iterator<const_iterator> Out>
+		Out find(const Keys &keys, Out out) const
+		{
+			auto const count = static_cast<std::size_t>(std::ranges::size(keys));
+			auto const first = std::ranges::begin(keys);
+			std::size_t nodes[batch_size];
+			for (std::size_t done{0}; done < count; done += batch_size) {
+				auto const group = std::min(batch_size, count - done);
+				auto const keyAt = [&](std::size_t i) -> decltype(auto) { return first[static_cast<std::ranges::range_difference_t<Keys>>(done + i)]; };
+				std::fill_n(nodes, group, std::size_t{1});
+				for (auto level = levels(); level > 0; --level) {
+					for (std::size_t i{0}; i < group; ++i)
+						nodes[i] = descend(nodes[i], keyAt(i));
+				}
+				for (std::size_t i{0}; i < group; ++i) {
+					auto const node = lastLowerBound(nodes[i]);
+					*out++ = node && !_comp(keyAt(i), _nodes[node]) ? at(node) : end();
+				}
+			}
+			return out;
+		}
+
+	  private:
+
+		static constexpr std::size_t batch_size{16};
+		static constexpr std::size_t prefetch_stride{std::max<std::size_t>(64 / sizeof(T), 1)}; //descendants a cache line of levels below
+
+		//fills the subtree of the node by the sorted values in order
+		void layOut(const std::vector<T> &sorted, std::size_t &next, std::size_t node)
+		{
+			if (node >= _nodes.size())
+				return;
+
+			layOut(sorted, next, 2 * node);
+			_nodes[node] = sorted[next++];
+			layOut(sorted, next, 2 * node + 1);
+		}
+
+		std::size_t levels() const noexcept { return static_cast<std::size_t>(std::bit_width(size())); }
+
+		void prefetchBelow(std::size_t node) const noexcept
+		{
+			//just a hint, so it may point past the nodes
+			Private::SearchKernels::Prefetch(reinterpret_cast<const void *>(reinterpret_cast<std::uintptr_t>(_nodes.data()) + node * prefetch_stride * sizeof(T)));
+		}
+
+		//one step down the tree, going right past the existing nodes, which leads to the same lower bound
+		template <class Key>
+		std::size_t descend(std::size_t node, const Key &key) const
+		{
+			prefetchBelow(node);
+			auto const exists = node < _nodes.size();
+			return 2 * node + (!exists || _comp(_nodes[exists ? node : 0], key));
+		}
+
+		//the node of the lower bound given the position below the leaves where the search ended, 0 if there is none
+		static std::size_t lastLowerBound(std::size_t position) noexcept
+		{
+			return position >> (std::countr_one(position) + 1);
+		}
+
+		template <class Key>
+		std::size_t lowerBound(const Key &key) const
+		{
+			std::size_t node{1};
+			while (node < _nodes.size()) {
+				prefetchBelow(node);
+				node = 2 * node + _comp(_nodes[node], key);
+			}
+			return lastLowerBound(node);
+		}
+
+		//next node in sorted order, 0 after the last one
+		std::size_t successor(std::size_t node) const noexcept
+		{
+			if (2 * node + 1 < _nodes.size()) {
+				node = 2 * node + 1;
+				while (2 * node < _nodes.size())
+					node *= 2;
+
+				return node;
+			}
+			return lastLowerBound(node);
+		}
+
+		const_iterator at(std::size_t node) const noexcept
+		{
+			return node ? _nodes.data() + node : end();
+		}
+
+		std::vector<T, Private::CacheLineAllocator<T>> _nodes; //the first slot at a cache line boundary
+		[[no_unique_address]] Compare _comp;
+	};
+
+} //ns Ctoolhu::Container
+
+#endif //file guard
@@ -0,0 +1,222 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_container_flat_map_included_
+#define _ctoolhu_container_flat_map_included_
+
+#include "flat_tree.hpp"
+#include <algorithm>
+#include <compare>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace std_ext {
+
+	//Map stored as a vector of key-value pairs sorted by key, in the manner of C++23 std::flat_map
+	//(though with the pairs stored together, as in boost::container::flat_map), for maps built in bulk and then mostly searched.
+	//The keys must not be modified through the iterators. Bulk insertion merges the pairs in, like flat_set, e.g.
+	//
+	//	std_ext::flat_map<std::string, int, std::less<>> counts;
+	//	counts.insert_range(pairs);
+	//	auto it = counts.find(std::string_view{"key"});	//heterogeneous lookup with a transparent comparator
+	//
+	template <class Key, class T, class Compare = std::less<Key>, class Container = std::vector<std::pair<Key, T>>>
+	class flat_map : private Private::FlatTree<Key, std::pair<Key, T>, Private::FirstKey, Compare, Container> {
+
+		using base_t = Private::FlatTree<Key, std::pair<Key, T>, Private::FirstKey, Compare, Container>;
+
+	  public:
+
+		using typename base_t::key_type;
+		using typename base_t::value_type;
+		using typename base_t::key_compare;
+		using typename base_t::container_type;
+		using typename base_t::size_type;
+		using typename base_t::difference_type;
+		using typename base_t::const_iterator;
+		using typename base_t::const_reverse_iterator;
+		using mapped_type = T;
+		using iterator = typename Container::iterator;
+		using reverse_iterator = typename Container::reverse_iterator;
+
+		//compares the pairs by their keys
+		class value_compare {
+
+		  public:
+
+			bool operator()(const value_type &a, const value_type &b) const { return _comp(a.first, b.first); }
+
+		  private:
+
+			friend class flat_map;
+
+			explicit value_compare(const Compare &comp) : _comp{comp} {}
+
+			[[no_unique_address]] Compare _comp;
+		};
+
+		using base_t::base_t;
+
+		flat_map() = default;
+
+		template <std::input_iterator Iterator>
+		flat_map(Iterator first, Iterator last, const Compare &comp = Compare{})
+			: base_t{Container(first, last), comp}
+		{}
+
+		template <std::input_iterator Iterator>
+		flat_map(sorted_unique_t, Iterator first, Iterator last, const Compare &comp = Compare{})
+			: base_t{sorted_unique, Container(first, last), comp}
+		{}
+
+		flat_map(std::initializer_list<value_type> values, const Compare &comp = Compare{})
+			: base_t{Container(values), comp}
+		{}
+
+		iterator begin() noexcept { return this->mutableValues().begin(); }
+		iterator end() noexcept { return this->mutableValues().end(); }
+		reverse_iterator rbegin() noexcept { return this->mutableValues().rbegin(); }
+		reverse_iterator rend() noexcept { return this->mutableValues().rend(); }
+
+		T &operator[](const Key &key) { return try_emplace(key).first->second; }
+		T &operator[](Key &&key) { return try_emplace(std::move(key)).first->second; }
+
+		T &at(const Key &key) { return const_cast<T &>(std::as_const(*this).at(key)); }
+		const T &at(const Key &key) const
+		{
+			auto const it = find(key);
+			if (it == end())
+				throw std::out_of_range("key not in the flat map");
+
+			return it->second;
+		}
+
+		iterator find(const Key &key) { return this->mutableIterator(this->findKey(key)); }
+		template <class K> requires Private::TransparentCompare<Compare>
+		iterator find(const K &key) { return this->mutableIterator(this->findKey(key)); }
+
+		iterator lower_bound(const Key &key) { return this->mutableIterator(this->lowerBound(key)); }
+		template <class K> requires Private::TransparentCompare<Compare>
+		iterator lower_bound(const K &key) { return this->mutableIterator(this->lowerBound(key)); }
+
+		iterator upper_bound(const Key &key) { return this->mutableIterator(this->upperBound(key)); }
+		template <class K> requires Private::TransparentCompare<Compare>
+		iterator upper_bound(const K &key) { return this->mutableIterator(this->upperBound(key)); }
+
+		std::pair<iterator, bool> insert(const value_type &value) { return this->emplaceUnique(value.first, value); }
+		std::pair<iterator, bool> insert(value_type &&value) { return this->emplaceUnique(value.first, std::move(value)); }
+
+		iterator insert(const_iterator hint, const value_type &value) { return this->emplaceHint(hint, value.first, value); }
+		iterator insert(const_iterator hint, value_type &&value) { return this->emplaceHint(hint, value.first, std::move(value)); }
+
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args &&... args)
+		{
+			return insert(value_type(std::forward<Args>(args)...));
+		}
+
+		template <class... Args>
+		iterator emplace_hint(const_iterator hint, Args &&... args)
+		{
+			return insert(hint, value_type(std::forward<Args>(args)...));
+		}
+
+		//constructs the mapped value only if the key is not present
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(const Key &key, Args &&... args)
+		{
+			return this->emplaceUnique(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+		}
+
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(Key &&key, Args &&... args)
+		{
+			return this->emplaceUnique(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		}
+
+		template <class Mapped>
+		std::pair<iterator, bool> insert_or_assign(const Key &key, Mapped &&mapped)
+		{
+			auto result = try_emplace(key, std::forward<Mapped>(mapped));
+			if (!result.second)
+				result.first->second = std::forward<Mapped>(mapped);
+
+			return result;
+		}
+
+		template <class Mapped>
+		std::pair<iterator, bool> insert_or_assign(Key &&key, Mapped &&mapped)
+		{
+			auto result = try_emplace(std::move(key), std::forward<Mapped>(mapped));
+			if (!result.second)
+				result.first->second = std::forward<Mapped>(mapped);
+
+			return result;
+		}
+
+		value_compare value_comp() const { return value_compare{base_t::key_comp()}; }
+
+		using base_t::begin;
+		using base_t::end;
+		using base_t::cbegin;
+		using base_t::cend;
+		using base_t::rbegin;
+		using base_t::rend;
+		using base_t::crbegin;
+		using base_t::crend;
+		using base_t::empty;
+		using base_t::size;
+		using base_t::max_size;
+		using base_t::capacity;
+		using base_t::reserve;
+		using base_t::shrink_to_fit;
+		using base_t::clear;
+		using base_t::key_comp;
+		using base_t::extract;
+		using base_t::replace;
+		using base_t::find;
+		using base_t::contains;
+		using base_t::count;
+		using base_t::lower_bound;
+		using base_t::upper_bound;
+		using base_t::equal_range;
+		using base_t::insert;
+		using base_t::insert_range;
+		using base_t::erase;
+
+		iterator erase(iterator pos) { return this->mutableIterator(base_t::erase(pos)); }
+
+		void swap(flat_map &other) noexcept { base_t::swap(other); }
+		friend void swap(flat_map &a, flat_map &b) noexcept { a.swap(b); }
+
+		//removes all pairs satisfying the predicate in one pass, returns their count
+		template <class Predicate>
+		size_type erase_if(Predicate &&pred) { return this->eraseIf(std::forward<Predicate>(pred)); }
+
+		friend bool operator==(const flat_map &a, const flat_map &b)
+		{
+			return std::ranges::equal(a, b);
+		}
+
+		friend auto operator<=>(const flat_map &a, const flat_map &b) requires std::three_way_comparable<value_type>
+		{
+			return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end());
+		}
+	};
+
+	//removes all pairs satisfying the predicate in one pass, returns their count
+	template <class Key, class T, class Compare, class Container, class Predicate>
+	auto erase_if(flat_map<Key, T, Compare, Container> &m, Predicate &&pred)
+	{
+		return m.erase_if(std::forward<Predicate>(pred));
+	}
+
+} //ns std_ext
+
+#endif //file guard
@@ -0,0 +1,137 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_container_flat_set_included_
+#define _ctoolhu_container_flat_set_included_
+
+#include "flat_tree.hpp"
+#include <algorithm>
+#include <compare>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+namespace std_ext {
+
+	//Set stored as a sorted vector, in the manner of C++23 std::flat_set, for sets built in bulk and then mostly searched.
+	//Instead of repeated insert_sorted, which is O(n^2) for n values, insert_range appends the values and merges them in, e.g.
+	//
+	//	std_ext::flat_set<int> ids{3, 1, 2};
+	//	ids.insert_range(moreIds);		//sorted and deduplicated at once
+	//	std_ext::erase_if(ids, [](int id) { return id < 0; });
+	//
+	template <class Key, class Compare = std::less<Key>, class Container = std::vector<Key>>
+	class flat_set : private Private::FlatTree<Key, Key, Private::IdentityKey, Compare, Container> {
+
+		using base_t = Private::FlatTree<Key, Key, Private::IdentityKey, Compare, Container>;
+
+	  public:
+
+		using typename base_t::key_type;
+		using typename base_t::value_type;
+		using typename base_t::key_compare;
+		using typename base_t::container_type;
+		using typename base_t::size_type;
+		using typename base_t::difference_type;
+		using typename base_t::const_iterator;
+		using typename base_t::const_reverse_iterator;
+		using iterator = const_iterator; //values in the set can't be modified
+		using reverse_iterator = const_reverse_iterator;
+		using value_compare = Compare;
+
+		using base_t::base_t;
+
+		flat_set() = default;
+
+		template <std::input_iterator Iterator>
+		flat_set(Iterator first, Iterator last, const Compare &comp = Compare{})
+			: base_t{Container(first, last), comp}
+		{}
+
+		template <std::input_iterator Iterator>
+		flat_set(sorted_unique_t, Iterator first, Iterator last, const Compare &comp = Compare{})
+			: base_t{sorted_unique, Container(first, last), comp}
+		{}
+
+		flat_set(std::initializer_list<Key> values, const Compare &comp = Compare{})
+			: base_t{Container(values), comp}
+		{}
+
+		std::pair<iterator, bool> insert(const Key &value) { return this->emplaceUnique(value, value); }
+		std::pair<iterator, bool> insert(Key &&value) { return this->emplaceUnique(value, std::move(value)); }
+
+		iterator insert(const_iterator hint, const Key &value) { return this->emplaceHint(hint, value, value); }
+		iterator insert(const_iterator hint, Key &&value) { return this->emplaceHint(hint, value, std::move(value)); }
+
+		template <class... Args>
+		std::pair<iterator, bool> emplace(Args &&... args)
+		{
+			return insert(Key(std::forward<Args>(args)...));
+		}
+
+		template <class... Args>
+		iterator emplace_hint(const_iterator hint, Args &&... args)
+		{
+			return insert(hint, Key(std::forward<Args>(args)...));
+		}
+
+		value_compare value_comp() const { return base_t::key_comp(); }
+
+		using base_t::begin;
+		using base_t::end;
+		using base_t::cbegin;
+		using base_t::cend;
+		using base_t::rbegin;
+		using base_t::rend;
+		using base_t::crbegin;
+		using base_t::crend;
+		using base_t::empty;
+		using base_t::size;
+		using base_t::max_size;
+		using base_t::capacity;
+		using base_t::reserve;
+		using base_t::shrink_to_fit;
+		using base_t::clear;
+		using base_t::key_comp;
+		using base_t::extract;
+		using base_t::replace;
+		using base_t::find;
+		using base_t::contains;
+		using base_t::count;
+		using base_t::lower_bound;
+		using base_t::upper_bound;
+		using base_t::equal_range;
+		using base_t::insert;
+		using base_t::insert_range;
+		using base_t::erase;
+
+		void swap(flat_set &other) noexcept { base_t::swap(other); }
+		friend void swap(flat_set &a, flat_set &b) noexcept { a.swap(b); }
+
+		template <class Predicate>
+		size_type erase_if(Predicate &&pred) { return this->eraseIf(std::forward<Predicate>(pred)); }
+
+		friend bool operator==(const flat_set &a, const flat_set &b)
+		{
+			return std::ranges::equal(a, b);
+		}
+
+		friend auto operator<=>(const flat_set &a, const flat_set &b) requires std::three_way_comparable<Key>
+		{
+			return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end());
+		}
+	};
+
+	//removes all values satisfying the predicate in one pass, returns their count
+	template <class Key, class Compare, class Container, class Predicate>
+	auto erase_if(flat_set<Key, Compare, Container> &s, Predicate &&pred)
+	{
+		return s.erase_if(std::forward<Predicate>(pred));
+	}
+
+} //ns std_ext
+
+#endif //file guard
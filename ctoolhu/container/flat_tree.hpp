@@ -0,0 +1,301 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_container_flat_tree_included_
+#define _ctoolhu_container_flat_tree_included_
+
+#include "../std_ext.hpp"
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
+#include <utility>
+
+namespace std_ext {
+
+	//tag of operations given values already sorted and without duplicates
+	struct sorted_unique_t { explicit sorted_unique_t() = default; };
+	inline constexpr sorted_unique_t sorted_unique{};
+
+	namespace Private {
+
+		template <class Compare>
+		concept TransparentCompare = requires { typename Compare::is_transparent; };
+
+		//key of a flat set value
+		struct IdentityKey {
+			template <class Value>
+			static constexpr const Value &get(const Value &v) noexcept { return v; }
+		};
+
+		//key of a flat map value
+		struct FirstKey {
+			template <class Value>
+			static constexpr const auto &get(const Value &v) noexcept { return v.first; }
+		};
+
+		//Sorted vector of unique values ordered by their keys, shared by flat_set and flat_map.
+		//Single insertions and erasures move the values after them, bulk insertions append the values and merge them in,
+		//lookups are the branchless binary searches of std_ext.
+		template <class Key, class Value, class KeyOf, class Compare, class Container>
+		class FlatTree {
+
+		  public:
+
+			using key_type = Key;
+			using value_type = Value;
+			using key_compare = Compare;
+			using container_type = Container;
+			using size_type = typename Container::size_type;
+			using difference_type = typename Container::difference_type;
+			using const_iterator = typename Container::const_iterator;
+			using const_reverse_iterator = typename Container::const_reverse_iterator;
+
+			FlatTree() = default;
+
+			explicit FlatTree(const Compare &comp) : _comp{comp} {}
+
+			//sorts the values and removes the duplicates
+			explicit FlatTree(Container values, const Compare &comp = Compare{})
+				: _values{std::move(values)}, _comp{comp}
+			{
+				mergeFrom(0, false);
+			}
+
+			FlatTree(sorted_unique_t, Container values, const Compare &comp = Compare{})
+				: _values{std::move(values)}, _comp{comp}
+			{
+				assert(isSortedUnique() && "values should be sorted and unique");
+			}
+
+			const_iterator begin() const noexcept { return _values.begin(); }
+			const_iterator end() const noexcept { return _values.end(); }
+			const_iterator cbegin() const noexcept { return _values.cbegin(); }
+			const_iterator cend() const noexcept { return _values.cend(); }
+			const_reverse_iterator rbegin() const noexcept { return _values.rbegin(); }
+			const_reverse_iterator rend() const noexcept { return _values.rend(); }
+			const_reverse_iterator crbegin() const noexcept { return _values.crbegin(); }
+			const_reverse_iterator crend() const noexcept { return _values.crend(); }
+
+			bool empty() const noexcept { return _values.empty(); }
+			size_type size() const noexcept { return _values.size(); }
+			size_type max_size() const noexcept { return _values.max_size(); }
+			size_type capacity() const noexcept { return _values.capacity(); }
+			void reserve(size_type capacity) { _values.reserve(capacity); }
+			void shrink_to_fit() { _values.shrink_to_fit(); }
+			void clear() noexcept { _values.clear(); }
+
+			key_compare key_comp() const { return _comp; }
+
+			//moves the sorted values out, leaving the container empty
+			Container extract() &&
+			{
+				auto values = std::move(_values);
+				_values.clear();
+				return values;
+			}
+
+			//takes over values already sorted and without duplicates
+			void replace(Container &&values)
+			{
+				_values = std::move(values);
+				assert(isSortedUnique() && "values should be sorted and unique");
+			}
+
+			const_iterator find(const Key &key) const { return findKey(key); }
+			template <class K> requires TransparentCompare<Compare>
+			const_iterator find(const K &key) const { return findKey(key); }
+
+			bool contains(const Key &key) const { return findKey(key) != end(); }
+			template <class K> requires TransparentCompare<Compare>
+			bool contains(const K &key) const { return findKey(key) != end(); }
+
+			size_type count(const Key &key) const { return contains(key) ? 1 : 0; }
+			template <class K> requires TransparentCompare<Compare>
+			size_type count(const K &key) const { return contains(key) ? 1 : 0; }
+
+			const_iterator lower_bound(const Key &key) const { return lowerBound(key); }
+			template <class K> requires TransparentCompare<Compare>
+			const_iterator lower_bound(const K &key) const { return lowerBound(key); }
+
+			const_iterator upper_bound(const Key &key) const { return upperBound(key); }
+			template <class K> requires TransparentCompare<Compare>
+			const_iterator upper_bound(const K &key) const { return upperBound(key); }
+
+			std::pair<const_iterator, const_iterator> equal_range(const Key &key) const { return {lowerBound(key), upperBound(key)}; }
+			template <class K> requires TransparentCompare<Compare>
+			std::pair<const_iterator, const_iterator> equal_range(const K &key) const { return {lowerBound(key), upperBound(key)}; }
+
+			template <std::input_iterator Iterator>
+			void insert(Iterator first, Iterator last)
+			{
+				insert_range(std::ranges::subrange(first, last));
+			}
+
+			template <std::input_iterator Iterator>
+			void insert(sorted_unique_t, Iterator first, Iterator last)
+			{
+				appendRange(std::ranges::subrange(first, last), true);
+			}
+
+			void insert(std::initializer_list<Value> values)
+			{
+				insert_range(values);
+			}
+
+			//Inserts many values in O(n log n) rather than one by one in O(n^2):
+			//the values are appended, sorted, merged with the present ones and deduplicated, keeping the present ones.
+			template <std::ranges::input_range Range>
+			void insert_range(Range &&values)
+			{
+				appendRange(std::forward<Range>(values), false);
+			}
+
+			size_type erase(const Key &key) { return eraseKey(key); }
+			template <class K> requires TransparentCompare<Compare> && (!std::convertible_to<K, const_iterator>)
+			size_type erase(K &&key) { return eraseKey(key); }
+
+			const_iterator erase(const_iterator pos) { return _values.erase(pos); }
+			const_iterator erase(const_iterator first, const_iterator last) { return _values.erase(first, last); }
+
+			void swap(FlatTree &other) noexcept
+			{
+				using std::swap;
+				swap(_values, other._values);
+				swap(_comp, other._comp);
+			}
+
+		  protected:
+
+			template <class K>
+			bool less(const Value &v, const K &key) const { return _comp(KeyOf::get(v), key); }
+
+			template <class K>
+			bool less(const K &key, const Value &v) const { return _comp(key, KeyOf::get(v)); }
+
+			bool less(const Value &a, const Value &b) const { return _comp(KeyOf::get(a), KeyOf::get(b)); }
+
+			template <class K>
+			const_iterator lowerBound(const K &key) const
+			{
+				return Private::LowerBound(_values, key, [this](const Value &v, const K &k) { return less(v, k); });
+			}
+
+			template <class K>
+			const_iterator upperBound(const K &key) const
+			{
+				return Private::UpperBound(_values, key, [this](const K &k, const Value &v) { return less(k, v); });
+			}
+
+			template <class K>
+			const_iterator findKey(const K &key) const
+			{
+				auto const pos = lowerBound(key);
+				return pos != end() && !less(key, *pos) ? pos : end();
+			}
+
+			//inserts the value unless there is one with equivalent key
+			template <class K, class... Args>
+			std::pair<typename Container::iterator, bool> emplaceUnique(const K &key, Args &&... args)
+			{
+				auto const pos = lowerBound(key);
+				if (pos != end() && !less(key, *pos))
+					return {mutableIterator(pos), false};
+
+				return {_values.emplace(pos, std::forward<Args>(args)...), true};
+			}
+
+			//like emplaceUnique, but if the value belongs right before the hint, finds its place in constant time
+			template <class K, class... Args>
+			typename Container::iterator emplaceHint(const_iterator hint, const K &key, Args &&... args)
+			{
+				if ((hint == end() || less(key, *hint)) && (hint == begin() || less(*std::prev(hint), key)))
+					return _values.emplace(hint, std::forward<Args>(args)...);
+
+				return emplaceUnique(key, std::forward<Args>(args)...).first;
+			}
+
+			template <class Predicate>
+			size_type eraseIf(Predicate &&pred)
+			{
+				auto const oldSize = _values.size();
+				std_ext::erase_if(_values, std::forward<Predicate>(pred));
+				return oldSize - _values.size();
+			}
+
+			typename Container::iterator mutableIterator(const_iterator pos)
+			{
+				return _values.begin() + (pos - _values.cbegin());
+			}
+
+			Container &mutableValues() noexcept { return _values; }
+
+		  private:
+
+			template <class K>
+			size_type eraseKey(const K &key)
+			{
+				auto const pos = findKey(key);
+				if (pos == end())
+					return 0;
+
+				_values.erase(pos);
+				return 1;
+			}
+
+			template <class Range>
+			void appendRange(Range &&values, bool sorted)
+			{
+				auto const oldSize = _values.size();
+				if constexpr (std::ranges::sized_range<Range>)
+					_values.reserve(oldSize + static_cast<size_type>(std::ranges::size(values)));
+
+				try {
+					for (auto &&v : values)
+						_values.emplace_back(std::forward<decltype(v)>(v));
+				}
+				catch (...) {
+					_values.erase(_values.begin() + static_cast<difference_type>(oldSize), _values.end());
+					throw;
+				}
+				mergeFrom(oldSize, sorted);
+			}
+
+			//Sorts the values appended after the first ones and merges them in.
+			//The merge is stable, so of equivalent values the present one is kept (of equivalent appended ones, any one is kept, as in std::flat_set).
+			void mergeFrom(size_type appendedFrom, bool sorted)
+			{
+				auto const valueLess = [this](const Value &a, const Value &b) { return less(a, b); };
+				auto const first = _values.begin(), middle = first + static_cast<difference_type>(appendedFrom), last = _values.end();
+				try {
+					if (!sorted)
+						std::sort(middle, last, valueLess);
+
+					if (middle != first && middle != last && valueLess(*middle, *std::prev(middle)))
+						std::inplace_merge(first, middle, last, valueLess);
+
+					erase_duplicates(_values, [this](const Value &a, const Value &b) { return !less(a, b) && !less(b, a); });
+				}
+				catch (...) {
+					_values.clear(); //the order may be broken, which leaves nothing valid
+					throw;
+				}
+			}
+
+			bool isSortedUnique() const
+			{
+				return std::adjacent_find(_values.begin(), _values.end(), [this](const Value &a, const Value &b) { return !less(a, b); }) == _values.end();
+			}
+
+			Container _values;
+			[[no_unique_address]] Compare _comp;
+		};
+
+	} //ns Private
+
+} //ns std_ext
+
+#endif //file guard
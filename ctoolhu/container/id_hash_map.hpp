@@ -0,0 +1,62 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_container_id_hash_map_included_
+#define _ctoolhu_container_id_hash_map_included_
+
+#include "id_hash_table.hpp"
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace Ctoolhu::Container {
+
+	//Flat hash map keyed by sparse ids, for ids too spread out for IdMap.
+	//The id-value pairs are stored inline in an open addressing table probed by groups of control bytes,
+	//so a lookup typically costs one probe of the control bytes and one access to the slot.
+	//Inserting or erasing invalidates the iterators and, unlike std::unordered_map, references to the values.
+	template <class Id, class T>
+	class IdHashMap : public Private::SwissTable::Table<Id, std::pair<const Id, T>> {
+
+		using base_t = Private::SwissTable::Table<Id, std::pair<const Id, T>>;
+
+	  public:
+
+		using mapped_type = T;
+		using typename base_t::value_type;
+		using typename base_t::iterator;
+		using typename base_t::const_iterator;
+
+		//constructs the value from given arguments unless the id is present already
+		template <class... Args>
+		std::pair<iterator, bool> try_emplace(Id id, Args &&... args)
+		{
+			return this->emplaceUnique(id, std::piecewise_construct, std::forward_as_tuple(id), std::forward_as_tuple(std::forward<Args>(args)...));
+		}
+
+		std::pair<iterator, bool> insert(const value_type &value) { return try_emplace(value.first, value.second); }
+		std::pair<iterator, bool> insert(value_type &&value) { return try_emplace(value.first, std::move(value.second)); }
+
+		//default-constructs the value if the id isn't present
+		T &operator[](Id id)
+		{
+			return try_emplace(id).first->second;
+		}
+
+		T &at(Id id)
+		{
+			if (auto it = this->find(id); it != this->end())
+				return it->second;
+
+			throw std::out_of_range("id not in the map");
+		}
+
+		const T &at(Id id) const
+		{
+			return const_cast<IdHashMap *>(this)->at(id);
+		}
+	};
+
+} //ns Ctoolhu::Container
+
+#endif //file guard
@@ -0,0 +1,60 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_container_id_hash_set_included_
+#define _ctoolhu_container_id_hash_set_included_
+
+#include "id_hash_table.hpp"
+#include <initializer_list>
+#include <utility>
+
+namespace Ctoolhu::Container {
+
+	//Flat hash set of sparse ids, for ids too spread out for IdSet.
+	//The ids are stored inline in an open addressing table probed by groups of control bytes.
+	template <class Id>
+	class IdHashSet : private Private::SwissTable::Table<Id, Id> {
+
+		using base_t = Private::SwissTable::Table<Id, Id>;
+
+	  public:
+
+		using typename base_t::key_type;
+		using typename base_t::value_type;
+		using typename base_t::size_type;
+		using iterator = typename base_t::const_iterator; //ids in the set can't be modified
+		using const_iterator = typename base_t::const_iterator;
+
+		IdHashSet() noexcept = default;
+
+		IdHashSet(std::initializer_list<Id> ids)
+		{
+			base_t::reserve(ids.size());
+			for (auto id : ids)
+				insert(id);
+		}
+
+		std::pair<iterator, bool> insert(Id id)
+		{
+			return this->emplaceUnique(id, id);
+		}
+
+		const_iterator find(Id id) const noexcept { return base_t::find(id); }
+		const_iterator erase(const_iterator pos) noexcept { return base_t::erase(pos); }
+
+		const_iterator begin() const noexcept { return base_t::begin(); }
+		const_iterator end() const noexcept { return base_t::end(); }
+
+		using base_t::contains;
+		using base_t::count;
+		using base_t::erase;
+		using base_t::clear;
+		using base_t::reserve;
+		using base_t::size;
+		using base_t::empty;
+		using base_t::capacity;
+	};
+
+} //ns Ctoolhu::Container
+
+#endif //file guard
@@ -0,0 +1,506 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_container_id_hash_table_included_
+#define _ctoolhu_container_id_hash_table_included_
+
+#include "simd.hpp"
+#include "../typesafe/id.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Ctoolhu::Container::Private::SwissTable {
+
+	//Control byte of a slot - the 7 lowest bits of the hash for a full slot, negative for a free one.
+	//The control bytes are scanned a group at a time, so a lookup mostly touches one cache line of them
+	//and then only the slots whose hash bits match.
+	using ctrl_t = std::int8_t;
+
+	constexpr ctrl_t ctrl_empty{-128};
+	constexpr ctrl_t ctrl_deleted{-2};
+	constexpr std::size_t group_size{16};
+
+	//spreads the bits of the id over the whole hash, since ids tend to be sequential
+	inline std::uint64_t Hash(std::uint64_t value) noexcept
+	{
+		value *= 0x9E3779B97F4A7C15ull;
+		return value ^ (value >> 32);
+	}
+
+	inline std::size_t H1(std::uint64_t hash) noexcept { return static_cast<std::size_t>(hash >> 7); }
+	inline ctrl_t H2(std::uint64_t hash) noexcept { return static_cast<ctrl_t>(hash & 0x7F); }
+
+	//matches the control bytes of a group of consecutive slots at once, bit i of a match stands for slot i of the group
+	class Group {
+
+	  public:
+
+		explicit Group(const ctrl_t *ctrl) noexcept
+#ifdef CTOOLHU_SIMD_SSE2
+			: _ctrl{_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl))} {}
+#else
+		{
+			std::memcpy(_ctrl, ctrl, group_size);
+		}
+#endif
+
+		std::uint32_t Match(ctrl_t h2) const noexcept
+		{
+#ifdef CTOOLHU_SIMD_SSE2
+			return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl)));
+#else
+			return matchIf([h2](ctrl_t c) { return c == h2; });
+#endif
+		}
+
+		std::uint32_t MatchEmpty() const noexcept
+		{
+#ifdef CTOOLHU_SIMD_SSE2
+			return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(ctrl_empty), _ctrl)));
+#else
+			return matchIf([](ctrl_t c) { return c == ctrl_empty; });
+#endif
+		}
+
+		//empty or deleted slots - the only ones with the sign bit set
+		std::uint32_t MatchFree() const noexcept
+		{
+#ifdef CTOOLHU_SIMD_SSE2
+			return static_cast<std::uint32_t>(_mm_movemask_epi8(_ctrl));
+#else
+			return matchIf([](ctrl_t c) { return c < 0; });
+#endif
+		}
+
+	  private:
+
+#ifdef CTOOLHU_SIMD_SSE2
+		__m128i _ctrl;
+#else
+		template <class Pred>
+		std::uint32_t matchIf(Pred pred) const noexcept
+		{
+			std::uint32_t mask{0};
+			for (std::size_t i{0}; i < group_size; ++i)
+				mask |= static_cast<std::uint32_t>(pred(_ctrl[i])) << i;
+
+			return mask;
+		}
+
+		ctrl_t _ctrl[group_size];
+#endif
+	};
+
+	//visits the groups of a table in triangular steps, which covers all groups of a power of two capacity
+	class ProbeSequence {
+
+	  public:
+
+		ProbeSequence(std::uint64_t hash, std::size_t mask) noexcept
+			: _mask{mask}, _offset{H1(hash) & mask} {}
+
+		std::size_t offset() const noexcept { return _offset; }
+		std::size_t offset(std::size_t i) const noexcept { return (_offset + i) & _mask; }
+
+		void next() noexcept
+		{
+			_index += group_size;
+			_offset = (_offset + _index) & _mask;
+		}
+
+	  private:
+
+		std::size_t _mask;
+		std::size_t _offset;
+		std::size_t _index{0};
+	};
+
+	//Open addressing hash table of slots keyed by ids, with the slots stored inline next to their control bytes.
+	//Slot is either the id itself (set) or a pair of the id and a value (map).
+	template <class Id, class Slot>
+	class Table {
+
+		static_assert(std::is_trivially_copyable_v<Id> && std::is_integral_v<typename Id::id_t>, "flat id table needs trivially copyable ids backed by an integral type");
+		static_assert(std::is_nothrow_move_constructible_v<Slot>, "slots are moved when the table grows");
+
+		template <bool Const>
+		class Iterator {
+
+			using slot_ptr = std::conditional_t<Const, const Slot *, Slot *>;
+
+		  public:
+
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Slot;
+			using difference_type = std::ptrdiff_t;
+			using pointer = slot_ptr;
+			using reference = std::conditional_t<Const, const Slot &, Slot &>;
+
+			Iterator() noexcept = default;
+
+			template <bool OtherConst>
+			Iterator(const Iterator<OtherConst> &other) noexcept requires (Const && !OtherConst)
+				: _ctrl{other._ctrl}, _slot{other._slot}, _end{other._end} {}
+
+			reference operator*() const noexcept { return *_slot; }
+			pointer operator->() const noexcept { return _slot; }
+
+			Iterator &operator++() noexcept
+			{
+				++_ctrl;
+				++_slot;
+				skipFree();
+				return *this;
+			}
+
+			Iterator operator++(int) noexcept
+			{
+				auto old = *this;
+				++*this;
+				return old;
+			}
+
+			bool operator==(const Iterator &other) const noexcept
+			{
+				return _ctrl == other._ctrl;
+			}
+
+		  private:
+
+			friend class Table;
+			template <bool> friend class Iterator;
+
+			Iterator(const ctrl_t *ctrl, slot_ptr slot, const ctrl_t *end) noexcept
+				: _ctrl{ctrl}, _slot{slot}, _end{end}
+			{
+				skipFree();
+			}
+
+			void skipFree() noexcept
+			{
+				while (_ctrl != _end && *_ctrl < 0) {
+					++_ctrl;
+					++_slot;
+				}
+			}
+
+			const ctrl_t *_ctrl{nullptr};
+			slot_ptr _slot{nullptr};
+			const ctrl_t *_end{nullptr};
+		};
+
+	  public:
+
+		using key_type = Id;
+		using value_type = Slot;
+		using size_type = std::size_t;
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+		Table() noexcept = default;
+
+		Table(const Table &src)
+		{
+			reserve(src._size);
+			for (auto const &slot : src)
+				insertNew(Hash(raw(keyOf(slot))), slot);
+		}
+
+		Table(Table &&src) noexcept
+			: _ctrl{std::exchange(src._ctrl, nullptr)}
+			, _slots{std::exchange(src._slots, nullptr)}
+			, _capacity{std::exchange(src._capacity, 0)}
+			, _size{std::exchange(src._size, 0)}
+			, _growthLeft{std::exchange(src._growthLeft, 0)} {}
+
+		Table &operator=(const Table &src)
+		{
+			if (this != &src) {
+				Table copy{src};
+				swap(copy);
+			}
+			return *this;
+		}
+
+		Table &operator=(Table &&src) noexcept
+		{
+			Table moved{std::move(src)};
+			swap(moved);
+			return *this;
+		}
+
+		~Table()
+		{
+			destroySlots();
+			deallocate();
+		}
+
+		void swap(Table &other) noexcept
+		{
+			std::swap(_ctrl, other._ctrl);
+			std::swap(_slots, other._slots);
+			std::swap(_capacity, other._capacity);
+			std::swap(_size, other._size);
+			std::swap(_growthLeft, other._growthLeft);
+		}
+
+		iterator find(Id id) noexcept
+		{
+			auto const i = indexOf(id);
+			return i == npos ? end() : iteratorAt(i);
+		}
+
+		const_iterator find(Id id) const noexcept
+		{
+			return const_cast<Table *>(this)->find(id);
+		}
+
+		bool contains(Id id) const noexcept
+		{
+			return indexOf(id) != npos;
+		}
+
+		size_type count(Id id) const noexcept
+		{
+			return contains(id) ? 1 : 0;
+		}
+
+		//returns the number of erased slots (0 or 1)
+		size_type erase(Id id) noexcept
+		{
+			auto const i = indexOf(id);
+			if (i == npos)
+				return 0;
+
+			eraseAt(i);
+			return 1;
+		}
+
+		iterator erase(const_iterator pos) noexcept
+		{
+			auto const i = static_cast<std::size_t>(pos._ctrl - _ctrl);
+			eraseAt(i);
+			return {_ctrl + i + 1, _slots + i + 1, _ctrl + _capacity};
+		}
+
+		void clear() noexcept
+		{
+			destroySlots();
+			if (_capacity)
+				std::memset(_ctrl, static_cast<unsigned char>(ctrl_empty), _capacity + group_size);
+
+			_size = 0;
+			_growthLeft = maxLoad(_capacity);
+		}
+
+		//makes room for given number of ids, so that inserting them doesn't rehash
+		void reserve(size_type count)
+		{
+			if (count > _size + _growthLeft)
+				rehash(std::max(capacityFor(count), _capacity));
+		}
+
+		size_type size() const noexcept { return _size; }
+		bool empty() const noexcept { return _size == 0; }
+		size_type capacity() const noexcept { return _capacity; }
+
+		iterator begin() noexcept { return {_ctrl, _slots, _ctrl + _capacity}; }
+		iterator end() noexcept { return {_ctrl + _capacity, _slots + _capacity, _ctrl + _capacity}; }
+		const_iterator begin() const noexcept { return const_cast<Table *>(this)->begin(); }
+		const_iterator end() const noexcept { return const_cast<Table *>(this)->end(); }
+
+	  protected:
+
+		//constructs the slot from given arguments unless the id is present already
+		template <class... Args>
+		std::pair<iterator, bool> emplaceUnique(Id id, Args &&... args)
+		{
+			auto const hash = Hash(raw(id));
+			if (auto const i = indexOf(id, hash); i != npos)
+				return {iteratorAt(i), false};
+
+			return {iteratorAt(insertNew(hash, std::forward<Args>(args)...)), true};
+		}
+
+	  private:
+
+		static constexpr std::size_t npos{static_cast<std::size_t>(-1)};
+		static constexpr std::size_t alignment{std::max(alignof(Slot), group_size)};
+
+		static std::uint64_t raw(Id id) noexcept
+		{
+			return static_cast<std::uint64_t>(underlying_value(id));
+		}
+
+		static Id keyOf(const Slot &slot) noexcept
+		{
+			if constexpr (std::is_same_v<Slot, Id>)
+				return slot;
+			else
+				return slot.first;
+		}
+
+		//the table is kept at most 7/8 full, so that probing always ends at an empty slot soon
+		static std::size_t maxLoad(std::size_t capacity) noexcept
+		{
+			return capacity - capacity / 8;
+		}
+
+		static std::size_t capacityFor(std::size_t count) noexcept
+		{
+			std::size_t capacity{group_size};
+			while (maxLoad(capacity) < count)
+				capacity *= 2;
+
+			return capacity;
+		}
+
+		static std::size_t slotsOffset(std::size_t capacity) noexcept
+		{
+			return (capacity + group_size + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+		}
+
+		iterator iteratorAt(std::size_t i) noexcept
+		{
+			return {_ctrl + i, _slots + i, _ctrl + _capacity};
+		}
+
+		std::size_t indexOf(Id id) const noexcept
+		{
+			return indexOf(id, Hash(raw(id)));
+		}
+
+		std::size_t indexOf(Id id, std::uint64_t hash) const noexcept
+		{
+			if (!_capacity)
+				return npos;
+
+			ProbeSequence seq{hash, _capacity - 1};
+			while (true) {
+				Group const group{_ctrl + seq.offset()};
+				for (auto match = group.Match(H2(hash)); match; match &= match - 1) {
+					auto const i = seq.offset(std::countr_zero(match));
+					if (keyOf(_slots[i]) == id)
+						return i;
+				}
+				if (group.MatchEmpty())
+					return npos;
+
+				seq.next();
+			}
+		}
+
+		std::size_t findFree(std::uint64_t hash) const noexcept
+		{
+			ProbeSequence seq{hash, _capacity - 1};
+			while (true) {
+				if (auto const match = Group{_ctrl + seq.offset()}.MatchFree())
+					return seq.offset(std::countr_zero(match));
+
+				seq.next();
+			}
+		}
+
+		//inserts a slot of an id known not to be present
+		template <class... Args>
+		std::size_t insertNew(std::uint64_t hash, Args &&... args)
+		{
+			auto i = _capacity ? findFree(hash) : npos;
+			if (i == npos || (_ctrl[i] == ctrl_empty && _growthLeft == 0)) {
+				//rehash in place if it frees enough deleted slots, otherwise grow
+				rehash(_size * 2 < maxLoad(_capacity) ? _capacity : std::max(_capacity * 2, group_size));
+				i = findFree(hash);
+			}
+			::new (static_cast<void *>(_slots + i)) Slot(std::forward<Args>(args)...);
+			if (_ctrl[i] == ctrl_empty)
+				--_growthLeft;
+
+			setCtrl(i, H2(hash));
+			++_size;
+			return i;
+		}
+
+		void eraseAt(std::size_t i) noexcept
+		{
+			_slots[i].~Slot();
+			setCtrl(i, ctrl_deleted);
+			--_size;
+		}
+
+		//the first group of control bytes is mirrored after the last slot, so that a group can be loaded from any slot
+		void setCtrl(std::size_t i, ctrl_t value) noexcept
+		{
+			_ctrl[i] = value;
+			if (i < group_size)
+				_ctrl[_capacity + i] = value;
+		}
+
+		void rehash(std::size_t capacity)
+		{
+			Table fresh;
+			fresh.allocate(capacity);
+			for (std::size_t i{0}; i < _capacity; ++i) {
+				if (_ctrl[i] < 0)
+					continue;
+
+				auto const hash = Hash(raw(keyOf(_slots[i])));
+				auto const j = fresh.findFree(hash);
+				::new (static_cast<void *>(fresh._slots + j)) Slot(std::move(_slots[i]));
+				fresh.setCtrl(j, H2(hash));
+				_slots[i].~Slot();
+			}
+			fresh._size = _size;
+			fresh._growthLeft = maxLoad(capacity) - _size;
+			_size = 0;
+			deallocate();
+			swap(fresh);
+		}
+
+		void allocate(std::size_t capacity)
+		{
+			auto const memory = ::operator new(slotsOffset(capacity) + capacity * sizeof(Slot), std::align_val_t{alignment});
+			_ctrl = static_cast<ctrl_t *>(memory);
+			_slots = reinterpret_cast<Slot *>(static_cast<std::byte *>(memory) + slotsOffset(capacity));
+			_capacity = capacity;
+			_growthLeft = maxLoad(capacity);
+			std::memset(_ctrl, static_cast<unsigned char>(ctrl_empty), capacity + group_size);
+		}
+
+		void deallocate() noexcept
+		{
+			if (_ctrl)
+				::operator delete(_ctrl, std::align_val_t{alignment});
+
+			_ctrl = nullptr;
+			_slots = nullptr;
+			_capacity = 0;
+			_growthLeft = 0;
+		}
+
+		void destroySlots() noexcept
+		{
+			if constexpr (!std::is_trivially_destructible_v<Slot>) {
+				for (std::size_t i{0}; i < _capacity; ++i) {
+					if (_ctrl[i] >= 0)
+						_slots[i].~Slot();
+				}
+			}
+		}
+
+		ctrl_t *_ctrl{nullptr};
+		Slot *_slots{nullptr};
+		std::size_t _capacity{0};	//zero or a power of two of at least a group size
+		std::size_t _size{0};
+		std::size_t _growthLeft{0};	//empty slots which can be filled before the table has to rehash
+	};
+
+} //ns Ctoolhu::Container::Private::SwissTable
+
+#endif //file guard
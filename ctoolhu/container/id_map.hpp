@@ -0,0 +1,165 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_container_id_map_included_
+#define _ctoolhu_container_id_map_included_
+
+#include "../typesafe/id.hpp"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Ctoolhu::Container {
+
+	//Map from ids to values for ids with holes, laid out as a sparse set:
+	//a sparse array indexed by the id points into dense arrays of ids and values.
+	//Lookup is two indexed loads, insertion and erasure are constant and iteration runs over the contiguous values.
+	//Erasure moves the last value in place of the erased one, so the iteration order isn't stable.
+	template <class Id, class T>
+	class IdMap {
+
+		using position_t = std::uint32_t;
+		static constexpr position_t npos{std::numeric_limits<position_t>::max()};
+
+	  public:
+
+		using id_t = Id;
+		using value_type = T;
+		using iterator = typename std::vector<T>::iterator;
+		using const_iterator = typename std::vector<T>::const_iterator;
+
+		//returns the value of the id and whether it has been inserted (false if the id was present already)
+		template <class... Args>
+		std::pair<T &, bool> try_emplace(Id id, Args &&... args)
+		{
+			if (auto value = find(id))
+				return {*value, false};
+
+			assert(std::in_range<std::size_t>(underlying_value(id)) && "negative id");
+			auto const i = index(id);
+			if (i >= _positions.size())
+				_positions.resize(i + 1, npos);
+
+			_values.emplace_back(std::forward<Args>(args)...);
+			try {
+				_ids.push_back(id);
+			}
+			catch (...) {
+				_values.pop_back();
+				throw;
+			}
+			_positions[i] = static_cast<position_t>(_values.size() - 1);
+			return {_values.back(), true};
+		}
+
+		//inserts default value if the id isn't present
+		T &operator[](Id id)
+		{
+			return try_emplace(id).first;
+		}
+
+		//returns nullptr if the id isn't present
+		T *find(Id id) noexcept
+		{
+			auto const pos = position(id);
+			return pos != npos ? &_values[pos] : nullptr;
+		}
+
+		const T *find(Id id) const noexcept
+		{
+			return const_cast<IdMap *>(this)->find(id);
+		}
+
+		bool contains(Id id) const noexcept
+		{
+			return position(id) != npos;
+		}
+
+		T &at(Id id)
+		{
+			if (auto value = find(id))
+				return *value;
+
+			throw std::out_of_range("id not present");
+		}
+
+		const T &at(Id id) const
+		{
+			return const_cast<IdMap *>(this)->at(id);
+		}
+
+		//returns false if the id wasn't present
+		bool erase(Id id)
+		{
+			auto const pos = position(id);
+			if (pos == npos)
+				return false;
+
+			if (pos != _values.size() - 1) {
+				_values[pos] = std::move(_values.back());
+				_ids[pos] = _ids.back();
+				_positions[index(_ids[pos])] = pos;
+			}
+			_values.pop_back();
+			_ids.pop_back();
+			_positions[index(id)] = npos;
+			return true;
+		}
+
+		void clear() noexcept
+		{
+			for (auto id : _ids)
+				_positions[index(id)] = npos;
+
+			_values.clear();
+			_ids.clear();
+		}
+
+		//prepares the map for ids lower than 'idBound' and for 'count' values
+		void reserve(std::size_t idBound, std::size_t count)
+		{
+			if (idBound > _positions.size())
+				_positions.resize(idBound, npos);
+
+			_values.reserve(count);
+			_ids.reserve(count);
+		}
+
+		//ids present in the map in the order of iteration
+		const std::vector<Id> &ids() const noexcept { return _ids; }
+
+		std::size_t size() const noexcept { return _values.size(); }
+		bool empty() const noexcept { return _values.empty(); }
+
+		iterator begin() noexcept { return _values.begin(); }
+		iterator end() noexcept { return _values.end(); }
+		const_iterator begin() const noexcept { return _values.begin(); }
+		const_iterator end() const noexcept { return _values.end(); }
+
+	  private:
+
+		static std::size_t index(Id id) noexcept
+		{
+			return static_cast<std::size_t>(underlying_value(id));
+		}
+
+		position_t position(Id id) const noexcept
+		{
+			if (!std::in_range<std::size_t>(underlying_value(id)) || index(id) >= _positions.size())
+				return npos;
+
+			return _positions[index(id)];
+		}
+
+		std::vector<position_t> _positions;	//sparse, indexed by id
+		std::vector<Id> _ids;				//dense
+		std::vector<T> _values;				//dense
+	};
+
+} //ns Ctoolhu::Container
+
+#endif //file guard
@@ -0,0 +1,333 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_container_id_set_included_
+#define _ctoolhu_container_id_set_included_
+
+#include "simd.hpp"
+#include "../typesafe/id.hpp"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace Ctoolhu::Container {
+
+	namespace Private::BitKernels {
+
+		using word_t = std::uint64_t;
+		constexpr std::size_t word_bits{64};
+
+		//word-wise operations, each providing the vector variants for the instruction set the library is compiled for
+
+		struct And {
+#ifdef CTOOLHU_SIMD_AVX2
+			__m256i operator()(__m256i a, __m256i b) const noexcept { return _mm256_and_si256(a, b); }
+#endif
+#ifdef CTOOLHU_SIMD_SSE2
+			__m128i operator()(__m128i a, __m128i b) const noexcept { return _mm_and_si128(a, b); }
+#endif
+			word_t operator()(word_t a, word_t b) const noexcept { return a & b; }
+		};
+
+		struct Or {
+#ifdef CTOOLHU_SIMD_AVX2
+			__m256i operator()(__m256i a, __m256i b) const noexcept { return _mm256_or_si256(a, b); }
+#endif
+#ifdef CTOOLHU_SIMD_SSE2
+			__m128i operator()(__m128i a, __m128i b) const noexcept { return _mm_or_si128(a, b); }
+#endif
+			word_t operator()(word_t a, word_t b) const noexcept { return a | b; }
+		};
+
+		struct AndNot {
+#ifdef CTOOLHU_SIMD_AVX2
+			__m256i operator()(__m256i a, __m256i b) const noexcept { return _mm256_andnot_si256(b, a); }
+#endif
+#ifdef CTOOLHU_SIMD_SSE2
+			__m128i operator()(__m128i a, __m128i b) const noexcept { return _mm_andnot_si128(b, a); }
+#endif
+			word_t operator()(word_t a, word_t b) const noexcept { return a & ~b; }
+		};
+
+		//dst[i] = op(dst[i], src[i])
+		template <class Op>
+		void Combine(word_t *dst, const word_t *src, std::size_t count, Op op) noexcept
+		{
+			std::size_t i{0};
+#if defined(CTOOLHU_SIMD_AVX2)
+			for (; i + 4 <= count; i += 4) {
+				auto const a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+				auto const b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), op(a, b));
+			}
+#elif defined(CTOOLHU_SIMD_SSE2)
+			for (; i + 2 <= count; i += 2) {
+				auto const a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+				auto const b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), op(a, b));
+			}
+#endif
+			for (; i < count; ++i)
+				dst[i] = op(dst[i], src[i]);
+		}
+
+		inline bool Intersect(const word_t *a, const word_t *b, std::size_t count) noexcept
+		{
+			std::size_t i{0};
+#if defined(CTOOLHU_SIMD_AVX2)
+			for (; i + 4 <= count; i += 4) {
+				auto const va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+				auto const vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+				if (!_mm256_testz_si256(va, vb))
+					return true;
+			}
+#elif defined(CTOOLHU_SIMD_SSE2)
+			for (; i + 2 <= count; i += 2) {
+				auto const va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+				auto const vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+				auto const zero = _mm_cmpeq_epi8(_mm_and_si128(va, vb), _mm_setzero_si128());
+				if (_mm_movemask_epi8(zero) != 0xFFFF)
+					return true;
+			}
+#endif
+			for (; i < count; ++i) {
+				if (a[i] & b[i])
+					return true;
+			}
+			return false;
+		}
+
+		inline std::size_t Count(const word_t *words, std::size_t count) noexcept
+		{
+			std::size_t total{0};
+			for (std::size_t i{0}; i < count; ++i)
+				total += static_cast<std::size_t>(std::popcount(words[i]));
+
+			return total;
+		}
+
+	} //ns Private::BitKernels
+
+	//Set of ids stored as a dense bitset, meant for ids which are small dense integers.
+	//Membership test, insertion and erasure are constant, set algebra is vectorized over whole words of bits, e.g.
+	//
+	//	IdSet<TeacherId> busy{teacherCount}, qualified{teacherCount};
+	//	...
+	//	for (auto teacher : qualified - busy)
+	//		...
+	//
+	template <class Id>
+	class IdSet {
+
+		using word_t = Private::BitKernels::word_t;
+		static constexpr std::size_t word_bits{Private::BitKernels::word_bits};
+
+	  public:
+
+		using id_t = Id;
+		using value_type = Id;
+
+		//iterates over the ids in the set in ascending order
+		class const_iterator {
+
+		  public:
+
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Id;
+			using difference_type = std::ptrdiff_t;
+			using pointer = void;
+			using reference = Id;
+
+			const_iterator() noexcept = default;
+
+			Id operator*() const noexcept
+			{
+				return Id{static_cast<typename Id::id_t>(_word * word_bits + std::countr_zero(_bits))};
+			}
+
+			const_iterator &operator++() noexcept
+			{
+				_bits &= _bits - 1; //clear the lowest set bit
+				skipEmpty();
+				return *this;
+			}
+
+			const_iterator operator++(int) noexcept
+			{
+				auto old = *this;
+				++*this;
+				return old;
+			}
+
+			bool operator==(const const_iterator &other) const noexcept
+			{
+				return _word == other._word && _bits == other._bits;
+			}
+
+		  private:
+
+			friend class IdSet;
+
+			const_iterator(const std::vector<word_t> *words, std::size_t word) noexcept
+				: _words{words}, _word{word}, _bits{word < words->size() ? (*words)[word] : 0}
+			{
+				skipEmpty();
+			}
+
+			void skipEmpty() noexcept
+			{
+				while (_bits == 0 && ++_word < _words->size())
+					_bits = (*_words)[_word];
+
+				if (_bits == 0)
+					_word = _words->size();
+			}
+
+			const std::vector<word_t> *_words{nullptr};
+			std::size_t _word{0};
+			word_t _bits{0};
+		};
+
+		using iterator = const_iterator;
+
+		IdSet() = default;
+
+		//prepares the set for ids lower than 'idBound'
+		explicit IdSet(std::size_t idBound)
+			: _words((idBound + word_bits - 1) / word_bits, 0) {}
+
+		IdSet(std::initializer_list<Id> ids)
+		{
+			for (auto id : ids)
+				insert(id);
+		}
+
+		//returns false if the id was present already
+		bool insert(Id id)
+		{
+			auto const i = index(id);
+			if (i / word_bits >= _words.size())
+				_words.resize(i / word_bits + 1, 0);
+
+			auto &word = _words[i / word_bits];
+			auto const mask = bit(i);
+			bool const inserted = !(word & mask);
+			word |= mask;
+			return inserted;
+		}
+
+		//returns false if the id wasn't present
+		bool erase(Id id) noexcept
+		{
+			if (!contains(id))
+				return false;
+
+			auto const i = index(id);
+			_words[i / word_bits] &= ~bit(i);
+			return true;
+		}
+
+		bool contains(Id id) const noexcept
+		{
+			if (!std::in_range<std::size_t>(underlying_value(id)))
+				return false;
+
+			auto const i = index(id);
+			return i / word_bits < _words.size() && (_words[i / word_bits] & bit(i));
+		}
+
+		//whether the sets have any id in common
+		bool intersects(const IdSet &other) const noexcept
+		{
+			return Private::BitKernels::Intersect(_words.data(), other._words.data(), std::min(_words.size(), other._words.size()));
+		}
+
+		IdSet &operator&=(const IdSet &other) noexcept
+		{
+			auto const common = std::min(_words.size(), other._words.size());
+			Private::BitKernels::Combine(_words.data(), other._words.data(), common, Private::BitKernels::And{});
+			std::fill(_words.begin() + common, _words.end(), 0);
+			return *this;
+		}
+
+		IdSet &operator|=(const IdSet &other)
+		{
+			if (other._words.size() > _words.size())
+				_words.resize(other._words.size(), 0);
+
+			Private::BitKernels::Combine(_words.data(), other._words.data(), other._words.size(), Private::BitKernels::Or{});
+			return *this;
+		}
+
+		//removes the ids present in the other set
+		IdSet &operator-=(const IdSet &other) noexcept
+		{
+			auto const common = std::min(_words.size(), other._words.size());
+			Private::BitKernels::Combine(_words.data(), other._words.data(), common, Private::BitKernels::AndNot{});
+			return *this;
+		}
+
+		//the result is moved out of the parameter, as returning the reference from the assignment would copy it
+		friend IdSet operator&(IdSet a, const IdSet &b) noexcept { a &= b; return a; }
+		friend IdSet operator|(IdSet a, const IdSet &b) { a |= b; return a; }
+		friend IdSet operator-(IdSet a, const IdSet &b) noexcept { a -= b; return a; }
+
+		friend bool operator==(const IdSet &a, const IdSet &b) noexcept
+		{
+			auto const common = std::min(a._words.size(), b._words.size());
+			auto const isZero = [](word_t w) { return w == 0; };
+			return std::equal(a._words.begin(), a._words.begin() + common, b._words.begin())
+				&& std::all_of(a._words.begin() + common, a._words.end(), isZero)
+				&& std::all_of(b._words.begin() + common, b._words.end(), isZero);
+		}
+
+		//number of ids in the set (counts the bits, so it is linear in the id bound)
+		std::size_t size() const noexcept
+		{
+			return Private::BitKernels::Count(_words.data(), _words.size());
+		}
+
+		bool empty() const noexcept
+		{
+			return std::all_of(_words.begin(), _words.end(), [](word_t w) { return w == 0; });
+		}
+
+		void clear() noexcept
+		{
+			std::fill(_words.begin(), _words.end(), 0);
+		}
+
+		//the set can hold ids lower than this without growing
+		std::size_t bound() const noexcept
+		{
+			return _words.size() * word_bits;
+		}
+
+		const_iterator begin() const noexcept { return {&_words, 0}; }
+		const_iterator end() const noexcept { return {&_words, _words.size()}; }
+
+	  private:
+
+		static std::size_t index(Id id) noexcept
+		{
+			assert(std::in_range<std::size_t>(underlying_value(id)) && "negative id");
+			return static_cast<std::size_t>(underlying_value(id));
+		}
+
+		static word_t bit(std::size_t index) noexcept
+		{
+			return word_t{1} << (index % word_bits);
+		}
+
+		std::vector<word_t> _words;
+	};
+
+} //ns Ctoolhu::Container
+
+#endif //file guard
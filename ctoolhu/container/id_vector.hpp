@@ -0,0 +1,121 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_container_id_vector_included_
+#define _ctoolhu_container_id_vector_included_
+
+#include "../typesafe/id.hpp"
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Ctoolhu::Container {
+
+	//Flat array of values indexed directly by ids, meant for ids which are small dense integers.
+	//Only the id type it is made for is accepted as an index, not the underlying integer nor ids of other objects, e.g.
+	//
+	//	IdVector<Id<Lesson>, Placement> placements(lessonCount);
+	//	placements[lesson.id()] = ...;
+	//
+	template <class Id, class T>
+	class IdVector {
+
+	  public:
+
+		using id_t = Id;
+		using value_type = T;
+		using iterator = typename std::vector<T>::iterator;
+		using const_iterator = typename std::vector<T>::const_iterator;
+
+		IdVector() = default;
+
+		explicit IdVector(std::size_t size, const T &value = T{})
+			: _values(size, value) {}
+
+		T &operator[](Id id) noexcept
+		{
+			assert(contains(id) && "id out of range");
+			return _values[index(id)];
+		}
+
+		const T &operator[](Id id) const noexcept
+		{
+			assert(contains(id) && "id out of range");
+			return _values[index(id)];
+		}
+
+		T &at(Id id)
+		{
+			if (!contains(id))
+				throw std::out_of_range("id out of range");
+
+			return _values[index(id)];
+		}
+
+		const T &at(Id id) const
+		{
+			return const_cast<IdVector *>(this)->at(id);
+		}
+
+		bool contains(Id id) const noexcept
+		{
+			return std::in_range<std::size_t>(underlying_value(id)) && index(id) < _values.size();
+		}
+
+		//enlarges the vector if needed so that it holds a value for the id
+		T &ensure(Id id, const T &value = T{})
+		{
+			assert(std::in_range<std::size_t>(underlying_value(id)) && "negative id");
+			if (index(id) >= _values.size())
+				_values.resize(index(id) + 1, value);
+
+			return _values[index(id)];
+		}
+
+		//appends a value, returns its id
+		template <class... Args>
+		Id emplace_back(Args &&... args)
+		{
+			_values.emplace_back(std::forward<Args>(args)...);
+			return id_of(_values.size() - 1);
+		}
+
+		Id push_back(const T &value) { return emplace_back(value); }
+		Id push_back(T &&value) { return emplace_back(std::move(value)); }
+
+		//id of the value at given position of the iteration
+		static Id id_of(std::size_t position) noexcept
+		{
+			return Id{static_cast<typename Id::id_t>(position)};
+		}
+
+		void resize(std::size_t size, const T &value = T{}) { _values.resize(size, value); }
+		void reserve(std::size_t size) { _values.reserve(size); }
+		void clear() noexcept { _values.clear(); }
+
+		std::size_t size() const noexcept { return _values.size(); }
+		bool empty() const noexcept { return _values.empty(); }
+
+		iterator begin() noexcept { return _values.begin(); }
+		iterator end() noexcept { return _values.end(); }
+		const_iterator begin() const noexcept { return _values.begin(); }
+		const_iterator end() const noexcept { return _values.end(); }
+
+		T *data() noexcept { return _values.data(); }
+		const T *data() const noexcept { return _values.data(); }
+
+	  private:
+
+		static std::size_t index(Id id) noexcept
+		{
+			return static_cast<std::size_t>(underlying_value(id));
+		}
+
+		std::vector<T> _values;
+	};
+
+} //ns Ctoolhu::Container
+
+#endif //file guard
@@ -0,0 +1,301 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_container_search_included_
+#define _ctoolhu_container_search_included_
+
+#include "simd.hpp"
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+
+namespace Ctoolhu::Container::Private::SearchKernels {
+
+	//Kernels comparing contiguous lanes with a value, e.g. the bit patterns of integers, enums or ids.
+	//Floating point lanes compare as numbers (so NaN is never found), the others bitwise.
+
+	template <class Lane>
+	concept SearchLane =
+		std::same_as<Lane, std::uint8_t> || std::same_as<Lane, std::uint16_t> || std::same_as<Lane, std::uint32_t> || std::same_as<Lane, std::uint64_t> ||
+		std::same_as<Lane, float> || std::same_as<Lane, double>;
+
+	//vector comparisons of each lane type, yielding a byte mask of the equal lanes
+	template <SearchLane Lane>
+	struct Lanes;
+
+	template <>
+	struct Lanes<std::uint8_t> {
+#ifdef CTOOLHU_SIMD_SSE2
+		static __m128i Set(std::uint8_t v) noexcept { return _mm_set1_epi8(static_cast<char>(v)); }
+		static unsigned Match(const std::byte *p, __m128i needle) noexcept
+		{
+			return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), needle)));
+		}
+#endif
+#ifdef CTOOLHU_TARGET_AVX2
+		CTOOLHU_TARGET_AVX2 static __m256i Set256(std::uint8_t v) noexcept { return _mm256_set1_epi8(static_cast<char>(v)); }
+		CTOOLHU_TARGET_AVX2 static std::uint32_t Match256(const std::byte *p, __m256i needle) noexcept
+		{
+			return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), needle)));
+		}
+#endif
+	};
+
+	template <>
+	struct Lanes<std::uint16_t> {
+#ifdef CTOOLHU_SIMD_SSE2
+		static __m128i Set(std::uint16_t v) noexcept { return _mm_set1_epi16(static_cast<short>(v)); }
+		static unsigned Match(const std::byte *p, __m128i needle) noexcept
+		{
+			return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), needle)));
+		}
+#endif
+#ifdef CTOOLHU_TARGET_AVX2
+		CTOOLHU_TARGET_AVX2 static __m256i Set256(std::uint16_t v) noexcept { return _mm256_set1_epi16(static_cast<short>(v)); }
+		CTOOLHU_TARGET_AVX2 static std::uint32_t Match256(const std::byte *p, __m256i needle) noexcept
+		{
+			return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), needle)));
+		}
+#endif
+	};
+
+	template <>
+	struct Lanes<std::uint32_t> {
+#ifdef CTOOLHU_SIMD_SSE2
+		static __m128i Set(std::uint32_t v) noexcept { return _mm_set1_epi32(static_cast<int>(v)); }
+		static unsigned Match(const std::byte *p, __m128i needle) noexcept
+		{
+			return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), needle)));
+		}
+#endif
+#ifdef CTOOLHU_TARGET_AVX2
+		CTOOLHU_TARGET_AVX2 static __m256i Set256(std::uint32_t v) noexcept { return _mm256_set1_epi32(static_cast<int>(v)); }
+		CTOOLHU_TARGET_AVX2 static std::uint32_t Match256(const std::byte *p, __m256i needle) noexcept
+		{
+			return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), needle)));
+		}
+#endif
+	};
+
+	template <>
+	struct Lanes<std::uint64_t> {
+#ifdef CTOOLHU_SIMD_SSE2
+		static __m128i Set(std::uint64_t v) noexcept { return _mm_set1_epi64x(static_cast<long long>(v)); }
+		static unsigned Match(const std::byte *p, __m128i needle) noexcept
+		{
+			//SSE2 compares 32-bit halves only, both halves of a lane must match
+			auto const halves = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), needle);
+			return static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)))));
+		}
+#endif
+#ifdef CTOOLHU_TARGET_AVX2
+		CTOOLHU_TARGET_AVX2 static __m256i Set256(std::uint64_t v) noexcept { return _mm256_set1_epi64x(static_cast<long long>(v)); }
+		CTOOLHU_TARGET_AVX2 static std::uint32_t Match256(const std::byte *p, __m256i needle) noexcept
+		{
+			return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), needle)));
+		}
+#endif
+	};
+
+	template <>
+	struct Lanes<float> {
+#ifdef CTOOLHU_SIMD_SSE2
+		static __m128 Set(float v) noexcept { return _mm_set1_ps(v); }
+		static unsigned Match(const std::byte *p, __m128 needle) noexcept
+		{
+			return static_cast<unsigned>(_mm_movemask_epi8(_mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(reinterpret_cast<const float *>(p)), needle))));
+		}
+#endif
+#ifdef CTOOLHU_TARGET_AVX2
+		CTOOLHU_TARGET_AVX2 static __m256 Set256(float v) noexcept { return _mm256_set1_ps(v); }
+		CTOOLHU_TARGET_AVX2 static std::uint32_t Match256(const std::byte *p, __m256 needle) noexcept
+		{
+			return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(reinterpret_cast<const float *>(p)), needle, _CMP_EQ_OQ))));
+		}
+#endif
+	};
+
+	template <>
+	struct Lanes<double> {
+#ifdef CTOOLHU_SIMD_SSE2
+		static __m128d Set(double v) noexcept { return _mm_set1_pd(v); }
+		static unsigned Match(const std::byte *p, __m128d needle) noexcept
+		{
+			return static_cast<unsigned>(_mm_movemask_epi8(_mm_castpd_si128(_mm_cmpeq_pd(_mm_loadu_pd(reinterpret_cast<const double *>(p)), needle))));
+		}
+#endif
+#ifdef CTOOLHU_TARGET_AVX2
+		CTOOLHU_TARGET_AVX2 static __m256d Set256(double v) noexcept { return _mm256_set1_pd(v); }
+		CTOOLHU_TARGET_AVX2 static std::uint32_t Match256(const std::byte *p, __m256d needle) noexcept
+		{
+			return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_castpd_si256(_mm256_cmp_pd(_mm256_loadu_pd(reinterpret_cast<const double *>(p)), needle, _CMP_EQ_OQ))));
+		}
+#endif
+	};
+
+	template <SearchLane Lane>
+	Lane Load(const std::byte *data, std::size_t index) noexcept
+	{
+		Lane lane;
+		std::memcpy(&lane, data + index * sizeof(Lane), sizeof(Lane));
+		return lane;
+	}
+
+	template <SearchLane Lane>
+	std::size_t FindScalar(const std::byte *data, std::size_t from, std::size_t size, Lane value) noexcept
+	{
+		for (auto i = from; i < size; ++i) {
+			if (Load<Lane>(data, i) == value)
+				return i;
+		}
+		return size;
+	}
+
+	template <SearchLane Lane>
+	std::size_t CountScalar(const std::byte *data, std::size_t from, std::size_t size, Lane value) noexcept
+	{
+		std::size_t count{0};
+		for (auto i = from; i < size; ++i)
+			count += Load<Lane>(data, i) == value;
+
+		return count;
+	}
+
+#ifdef CTOOLHU_SIMD_SSE2
+	template <SearchLane Lane>
+	std::size_t FindSse2(const std::byte *data, std::size_t size, Lane value) noexcept
+	{
+		constexpr std::size_t step{16 / sizeof(Lane)};
+		auto const needle = Lanes<Lane>::Set(value);
+		std::size_t i{0};
+		for (; i + step <= size; i += step) {
+			if (auto const mask = Lanes<Lane>::Match(data + i * sizeof(Lane), needle))
+				return i + static_cast<std::size_t>(std::countr_zero(mask)) / sizeof(Lane);
+		}
+		return FindScalar(data, i, size, value);
+	}
+
+	template <SearchLane Lane>
+	std::size_t CountSse2(const std::byte *data, std::size_t size, Lane value) noexcept
+	{
+		constexpr std::size_t step{16 / sizeof(Lane)};
+		auto const needle = Lanes<Lane>::Set(value);
+		std::size_t i{0}, matchingBytes{0};
+		for (; i + step <= size; i += step)
+			matchingBytes += static_cast<std::size_t>(std::popcount(Lanes<Lane>::Match(data + i * sizeof(Lane), needle)));
+
+		return matchingBytes / sizeof(Lane) + CountScalar(data, i, size, value);
+	}
+#endif
+
+#ifdef CTOOLHU_TARGET_AVX2
+	//compares two vectors per iteration to take one branch per 64 bytes
+	template <SearchLane Lane>
+	CTOOLHU_TARGET_AVX2 std::size_t FindAvx2(const std::byte *data, std::size_t size, Lane value) noexcept
+	{
+		constexpr std::size_t step{32 / sizeof(Lane)};
+		auto const needle = Lanes<Lane>::Set256(value);
+		std::size_t i{0};
+		for (; i + 2 * step <= size; i += 2 * step) {
+			auto const p = data + i * sizeof(Lane);
+			auto const mask = Lanes<Lane>::Match256(p, needle) | (std::uint64_t{Lanes<Lane>::Match256(p + 32, needle)} << 32);
+			if (mask)
+				return i + static_cast<std::size_t>(std::countr_zero(mask)) / sizeof(Lane);
+		}
+		if (i + step <= size) {
+			if (auto const mask = Lanes<Lane>::Match256(data + i * sizeof(Lane), needle))
+				return i + static_cast<std::size_t>(std::countr_zero(mask)) / sizeof(Lane);
+
+			i += step;
+		}
+		return FindScalar(data, i, size, value);
+	}
+
+	template <SearchLane Lane>
+	CTOOLHU_TARGET_AVX2 std::size_t CountAvx2(const std::byte *data, std::size_t size, Lane value) noexcept
+	{
+		constexpr std::size_t step{32 / sizeof(Lane)};
+		auto const needle = Lanes<Lane>::Set256(value);
+		std::size_t i{0}, matchingBytes{0};
+		for (; i + step <= size; i += step)
+			matchingBytes += static_cast<std::size_t>(std::popcount(Lanes<Lane>::Match256(data + i * sizeof(Lane), needle)));
+
+		return matchingBytes / sizeof(Lane) + CountScalar(data, i, size, value);
+	}
+#endif
+
+	//index of the first of the lanes equal to the value, or size if there's none
+	template <SearchLane Lane>
+	std::size_t Find(const void *lanes, std::size_t size, Lane value) noexcept
+	{
+		auto const data = static_cast<const std::byte *>(lanes);
+#if defined(CTOOLHU_SIMD_AVX2)
+		return FindAvx2(data, size, value);
+#elif defined(CTOOLHU_SIMD_AVX2_DISPATCH)
+		return HasAvx2() ? FindAvx2(data, size, value) : FindSse2(data, size, value);
+#elif defined(CTOOLHU_SIMD_SSE2)
+		return FindSse2(data, size, value);
+#else
+		return FindScalar(data, 0, size, value);
+#endif
+	}
+
+	//number of the lanes equal to the value
+	template <SearchLane Lane>
+	std::size_t Count(const void *lanes, std::size_t size, Lane value) noexcept
+	{
+		auto const data = static_cast<const std::byte *>(lanes);
+#if defined(CTOOLHU_SIMD_AVX2)
+		return CountAvx2(data, size, value);
+#elif defined(CTOOLHU_SIMD_AVX2_DISPATCH)
+		return HasAvx2() ? CountAvx2(data, size, value) : CountSse2(data, size, value);
+#elif defined(CTOOLHU_SIMD_SSE2)
+		return CountSse2(data, size, value);
+#else
+		return CountScalar(data, 0, size, value);
+#endif
+	}
+
+	//hints the processor to start loading the cache line with given address
+	inline void Prefetch(const void *address) noexcept
+	{
+#if defined(__GNUC__)
+		__builtin_prefetch(address);
+#elif defined(CTOOLHU_SIMD_SSE2)
+		_mm_prefetch(static_cast<const char *>(address), _MM_HINT_T0);
+#else
+		(void)address;
+#endif
+	}
+
+	//Branchless binary search for the first position in [first, first + length) where the predicate is false
+	//(given it is true up to some position and false after it).
+	//The halving doesn't depend on the comparisons, so they compile to conditional moves rather than mispredicted branches,
+	//and both possible next midpoints are prefetched while the current one is compared.
+	template <std::random_access_iterator Iterator, class Predicate>
+	constexpr Iterator PartitionPoint(Iterator first, std::iter_difference_t<Iterator> length, Predicate pred)
+	{
+		if (length == 0)
+			return first;
+
+		while (length > 1) {
+			auto const half = length / 2;
+			if constexpr (std::contiguous_iterator<Iterator>) {
+				if (!std::is_constant_evaluated()) {
+					Prefetch(std::to_address(first + half / 2));
+					Prefetch(std::to_address(first + half + half / 2));
+				}
+			}
+			first = pred(first[half]) ? first + half : first;
+			length -= half;
+		}
+		return pred(*first) ? first + 1 : first;
+	}
+
+} //ns Ctoolhu::Container::Private::SearchKernels
+
+#endif //file guard
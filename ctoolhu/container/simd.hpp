@@ -0,0 +1,65 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_container_simd_included_
+#define _ctoolhu_container_simd_included_
+
+//vector instruction set the containers are compiled for, detected from the compiler's target options
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CTOOLHU_SIMD_AVX2
+#define CTOOLHU_SIMD_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CTOOLHU_SIMD_SSE2
+#endif
+
+//Without targeting AVX2, kernels marked CTOOLHU_TARGET_AVX2 can still be compiled for it
+//and picked at run time if Private::HasAvx2() (CTOOLHU_SIMD_AVX2_DISPATCH).
+#if defined(CTOOLHU_SIMD_AVX2)
+#define CTOOLHU_TARGET_AVX2
+#elif defined(CTOOLHU_SIMD_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CTOOLHU_SIMD_AVX2_DISPATCH
+#define CTOOLHU_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(CTOOLHU_SIMD_SSE2) && defined(_MSC_VER) && !defined(__clang__)
+#include <immintrin.h>
+#include <intrin.h>
+#define CTOOLHU_SIMD_AVX2_DISPATCH
+#define CTOOLHU_TARGET_AVX2
+#endif
+
+#ifdef CTOOLHU_SIMD_AVX2_DISPATCH
+namespace Ctoolhu::Container::Private {
+
+	//whether the processor running the program supports AVX2 (queried once)
+	inline bool HasAvx2() noexcept
+	{
+#ifdef __GNUC__
+		static bool const avx2{[] {
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2") != 0;
+		}()};
+#else
+		static bool const avx2{[] {
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7)
+				return false;
+
+			__cpuid(info, 1);
+			constexpr int osxsave{1 << 27}, avx{1 << 28};
+			if ((info[2] & (osxsave | avx)) != (osxsave | avx) || (_xgetbv(0) & 6) != 6) //the OS must save the ymm registers too
+				return false;
+
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+		}()};
+#endif
+		return avx2;
+	}
+
+} //ns Ctoolhu::Container::Private
+#endif
+
+#endif //file guard
@@ -0,0 +1,236 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_container_slot_map_included_
+#define _ctoolhu_container_slot_map_included_
+
+#include "../typesafe/id.hpp"
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Ctoolhu::Container {
+
+	//Container storing values densely in contiguous memory, addressed by generation-checked keys.
+	//Insertion, erasure and lookup are constant, iteration runs over the contiguous values (in no particular order).
+	//The key is an id whose lower half of bits is the slot index and the upper half the generation of the slot,
+	//so a key of an erased value is detected as stale even if its slot has been reused, e.g.
+	//
+	//	SlotMap<Lesson> lessons;
+	//	auto key = lessons.emplace(...);	//key is TypeSafe::Id<Lesson, std::uint64_t>
+	//	lessons.erase(key);
+	//	assert(!lessons.contains(key));
+	//
+	template <
+		class T,
+		class Key = TypeSafe::Id<T, std::uint64_t>	//any TypeSafe::Id with unsigned integral id type
+	>
+	class SlotMap {
+
+		using raw_key_t = typename Key::id_t;
+		static_assert(std::unsigned_integral<raw_key_t>, "slot map key must be backed by an unsigned integral type");
+
+		static constexpr int half_bits{std::numeric_limits<raw_key_t>::digits / 2};
+		static constexpr raw_key_t index_mask{(raw_key_t{1} << half_bits) - 1};
+
+		using index_t = raw_key_t; //slot index or generation, each fits into half of the bits
+
+		struct Slot {
+			index_t index;		//of the value if the slot is occupied, of the next free slot otherwise
+			index_t generation;	//incremented whenever the value in the slot is erased
+		};
+
+	  public:
+
+		using key_t = Key;
+		using value_type = T;
+		using iterator = typename std::vector<T>::iterator;
+		using const_iterator = typename std::vector<T>::const_iterator;
+
+		template <class... Args>
+		key_t emplace(Args &&... args)
+		{
+			auto const slotIndex = acquireSlot();
+			try {
+				_values.emplace_back(std::forward<Args>(args)...);
+				_valueSlots.push_back(slotIndex);
+			}
+			catch (...) {
+				if (_values.size() > _valueSlots.size())
+					_values.pop_back();
+
+				releaseSlot(slotIndex);
+				throw;
+			}
+			auto &slot = _slots[slotIndex];
+			slot.index = static_cast<index_t>(_values.size() - 1);
+			return makeKey(slotIndex, slot.generation);
+		}
+
+		key_t insert(const T &value) { return emplace(value); }
+		key_t insert(T &&value) { return emplace(std::move(value)); }
+
+		//returns false if the key is stale
+		bool erase(key_t key)
+		{
+			auto const slot = validSlot(key);
+			if (!slot)
+				return false;
+
+			auto const index = slot->index;
+			if (index != _values.size() - 1) {
+				_values[index] = std::move(_values.back());
+				_valueSlots[index] = _valueSlots.back();
+				_slots[_valueSlots[index]].index = index;
+			}
+			_values.pop_back();
+			_valueSlots.pop_back();
+			releaseSlot(slotIndexOf(key));
+			return true;
+		}
+
+		//returns nullptr if the key is stale
+		T *find(key_t key) noexcept
+		{
+			auto const slot = validSlot(key);
+			return slot ? &_values[slot->index] : nullptr;
+		}
+
+		const T *find(key_t key) const noexcept
+		{
+			return const_cast<SlotMap *>(this)->find(key);
+		}
+
+		bool contains(key_t key) const noexcept
+		{
+			return validSlot(key) != nullptr;
+		}
+
+		T &operator[](key_t key) noexcept
+		{
+			assert(contains(key) && "stale slot map key");
+			return _values[_slots[slotIndexOf(key)].index];
+		}
+
+		const T &operator[](key_t key) const noexcept
+		{
+			assert(contains(key) && "stale slot map key");
+			return _values[_slots[slotIndexOf(key)].index];
+		}
+
+		T &at(key_t key)
+		{
+			if (auto value = find(key))
+				return *value;
+
+			throw std::out_of_range("stale slot map key");
+		}
+
+		const T &at(key_t key) const
+		{
+			return const_cast<SlotMap *>(this)->at(key);
+		}
+
+		//key of the value at given position of the iteration
+		key_t key_at(std::size_t position) const noexcept
+		{
+			auto const slotIndex = _valueSlots[position];
+			return makeKey(slotIndex, _slots[slotIndex].generation);
+		}
+
+		void reserve(std::size_t count)
+		{
+			_values.reserve(count);
+			_valueSlots.reserve(count);
+			_slots.reserve(count);
+		}
+
+		//erases all values, invalidating all keys
+		void clear() noexcept
+		{
+			for (auto slotIndex : _valueSlots)
+				releaseSlot(slotIndex);
+
+			_values.clear();
+			_valueSlots.clear();
+		}
+
+		std::size_t size() const noexcept { return _values.size(); }
+		bool empty() const noexcept { return _values.empty(); }
+
+		iterator begin() noexcept { return _values.begin(); }
+		iterator end() noexcept { return _values.end(); }
+		const_iterator begin() const noexcept { return _values.begin(); }
+		const_iterator end() const noexcept { return _values.end(); }
+
+		T *data() noexcept { return _values.data(); }
+		const T *data() const noexcept { return _values.data(); }
+
+	  private:
+
+		static constexpr index_t no_slot{index_mask};
+
+		static key_t makeKey(index_t slotIndex, index_t generation) noexcept
+		{
+			return key_t{static_cast<raw_key_t>((generation << half_bits) | slotIndex)};
+		}
+
+		static index_t slotIndexOf(key_t key) noexcept
+		{
+			return underlying_value(key) & index_mask;
+		}
+
+		static index_t generationOf(key_t key) noexcept
+		{
+			return underlying_value(key) >> half_bits;
+		}
+
+		const Slot *validSlot(key_t key) const noexcept
+		{
+			auto const slotIndex = slotIndexOf(key);
+			if (slotIndex >= _slots.size())
+				return nullptr;
+
+			auto &slot = _slots[slotIndex];
+			return slot.generation == generationOf(key) ? &slot : nullptr;
+		}
+
+		//occupied slots have an even generation, free ones an odd generation
+		index_t acquireSlot()
+		{
+			if (_freeSlot != no_slot) {
+				auto const slotIndex = _freeSlot;
+				auto &slot = _slots[slotIndex];
+				_freeSlot = slot.index;
+				slot.generation = (slot.generation + 1) & index_mask;
+				return slotIndex;
+			}
+			if (_slots.size() == no_slot)
+				throw std::length_error("slot map is full");
+
+			_slots.push_back({0, 0});
+			return static_cast<index_t>(_slots.size() - 1);
+		}
+
+		void releaseSlot(index_t slotIndex) noexcept
+		{
+			auto &slot = _slots[slotIndex];
+			slot.generation = (slot.generation + 1) & index_mask;
+			slot.index = _freeSlot;
+			_freeSlot = slotIndex;
+		}
+
+		std::vector<T> _values;
+		std::vector<index_t> _valueSlots;	//slot of each value
+		std::vector<Slot> _slots;
+		index_t _freeSlot{no_slot};			//head of the list of free slots
+	};
+
+} //ns Ctoolhu::Container
+
+#endif //file guard
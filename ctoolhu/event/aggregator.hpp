@@ -4,8 +4,15 @@
 #ifndef _ctoolhu_event_aggregator_included_
 #define _ctoolhu_event_aggregator_included_
 
+#include "key.hpp"
 #include "../singleton/holder.hpp"
 #include <boost/signals2.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 namespace Ctoolhu::Event {
 
@@ -13,6 +20,83 @@ namespace Ctoolhu::Event {
 
 	namespace Private {
 
+		//keyed subscriptions are not available for events without an EventKey specialization
+		template <class Event>
+		class KeyedSignals {
+
+		  public:
+
+			void Fire(Event *) const noexcept {}
+		};
+
+		//index of signals by event key, so that firing an event reaches only the subscribers of its key
+		template <KeyedEvent Event>
+		class KeyedSignals<Event> {
+
+			using key_t = event_key_t<Event>;
+			using signal_t = boost::signals2::signal<void (Event *)>;
+
+		  public:
+
+			connection_t Subscribe(const key_t &key, const typename signal_t::slot_type &handler)
+			{
+				//connected under the lock, so that the signal can't be pruned meanwhile
+				std::lock_guard lock{_mutex};
+				auto it = _signals.find(key);
+				if (it == _signals.end()) {
+					if (_signals.size() >= _sweepSize) {
+						std::erase_if(_signals, [](const auto &s) { return s.second->empty(); });
+						_sweepSize = std::max(min_sweep_size, 2 * _signals.size());
+					}
+					it = _signals.emplace(key, std::make_shared<signal_t>()).first;
+				}
+				return it->second->connect(handler);
+			}
+
+			void Fire(Event *e) const
+			{
+				auto const &key = EventKey<Event>::get(*e);
+				std::shared_ptr<signal_t> signal; //keeps the signal alive outside the lock even if it gets pruned
+				{
+					std::shared_lock lock{_mutex};
+					auto it = _signals.find(key);
+					if (it == _signals.end())
+						return;
+
+					signal = it->second;
+				}
+				if (signal->empty())
+					prune(key);
+				else
+					(*signal)(e);
+			}
+
+			//number of keys with a signal, including those whose handlers have disconnected but weren't pruned yet
+			std::size_t KeyCount() const
+			{
+				std::shared_lock lock{_mutex};
+				return _signals.size();
+			}
+
+		  private:
+
+			static constexpr std::size_t min_sweep_size{64};
+
+			//removes the signal of the key if all its handlers have disconnected
+			void prune(const key_t &key) const
+			{
+				std::lock_guard lock{_mutex};
+				if (auto it = _signals.find(key); it != _signals.end() && it->second->empty())
+					_signals.erase(it);
+			}
+
+			//Signals without handlers are pruned when an event of their key is fired,
+			//and all of them when the map has doubled since the last sweep, so that keys of e.g. transient entities don't accumulate.
+			mutable std::unordered_map<key_t, std::shared_ptr<signal_t>, event_key_hash_t<Event>> _signals;
+			std::size_t _sweepSize{min_sweep_size}; //number of signals at which they are swept by the next subscription of a new key
+			mutable std::shared_mutex _mutex;
+		};
+
 		//facilitates event handling between unrelated publishers and subscribers
 		template <class Event>
 		class Aggregator {
@@ -27,19 +111,29 @@ namespace Ctoolhu::Event {
 			using signal_t = boost::signals2::signal<void (Event *)>;
 			using slot_t = typename signal_t::slot_type;
 			  
+			//subscribes the handler to all events of the type
 			connection_t Subscribe(const slot_t &handler)
 			{
 				return _signal.connect(handler);
 			}
 
+			//subscribes the handler only to events with given key (see EventKey)
+			template <KeyedEvent E = Event>
+			connection_t Subscribe(const event_key_t<E> &key, const slot_t &handler)
+			{
+				return _keyedSignals.Subscribe(key, handler);
+			}
+
+			//invokes all subscribers of the event type first, then the subscribers of the event's key
 			void Fire(const Event &e) const
 			{
-				_signal(const_cast<Event *>(&e)); //TODO is there a way without const cast? I.e., can we have more than one signal_t?
+				Fire(const_cast<Event &>(e)); //TODO is there a way without const cast? I.e., can we have more than one signal_t?
 			}
 
 			void Fire(Event &e) const
 			{
 				_signal(&e);
+				_keyedSignals.Fire(&e);
 			}
 
 		  private:
@@ -48,6 +142,7 @@ namespace Ctoolhu::Event {
 			Aggregator() noexcept = default;
 
 			signal_t _signal;
+			KeyedSignals<Event> _keyedSignals;
 		};
 
 		template <class Event>
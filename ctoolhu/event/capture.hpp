@@ -0,0 +1,105 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_event_capture_included_
+#define _ctoolhu_event_capture_included_
+
+#include "events.h"
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Ctoolhu::Event {
+
+	//Trait describing how an event is stored in the capture log used by Recorder and Replayer.
+	//Trivially copyable events are stored as they are, other events need a specialization
+	//providing Write (appending the event to the buffer) and Read (restoring the event from the bytes).
+	template <class Event>
+	struct EventSerializer;
+
+	template <class Event> requires std::is_trivially_copyable_v<Event>
+	struct EventSerializer<Event> {
+
+		static void Write(const Event &e, std::vector<std::byte> &out)
+		{
+			auto const bytes = reinterpret_cast<const std::byte *>(&e);
+			out.insert(out.end(), bytes, bytes + sizeof(Event));
+		}
+
+		//throws std::runtime_error if the record doesn't hold exactly one event (a log truncated or of other events)
+		static Event Read(std::span<const std::byte> in)
+		{
+			if (in.size() != sizeof(Event))
+				throw std::runtime_error("event capture record of unexpected size");
+
+			std::array<std::byte, sizeof(Event)> bytes; //copied, since the log gives no alignment guarantees
+			std::memcpy(bytes.data(), in.data(), sizeof(Event));
+			return std::bit_cast<Event>(bytes);
+		}
+	};
+
+	template <>
+	struct EventSerializer<Message> {
+
+		static void Write(const Message &e, std::vector<std::byte> &out)
+		{
+			auto const bytes = reinterpret_cast<const std::byte *>(e.msg.data());
+			out.insert(out.end(), bytes, bytes + e.msg.size());
+		}
+
+		static Message Read(std::span<const std::byte> in)
+		{
+			return {std::string(reinterpret_cast<const char *>(in.data()), in.size())};
+		}
+	};
+
+	template <class Event>
+	concept SerializableEvent = requires(const Event &e, std::vector<std::byte> &out, std::span<const std::byte> in) {
+		EventSerializer<Event>::Write(e, out);
+		{ EventSerializer<Event>::Read(in) } -> std::same_as<Event>;
+	};
+
+	namespace Private::Capture {
+
+		//Layout of the capture log (native byte order, so replay it on the same platform it was recorded on):
+		//
+		//	header:	magic, number of event types the recorder was instantiated with
+		//	record:	nanoseconds since the start of the capture, index of the event type, payload size, payload
+		//
+		constexpr std::array<char, 8> magic{'C', 'T', 'H', 'U', 'E', 'V', '0', '1'};
+
+		using timestamp_t = std::uint64_t;
+		using type_index_t = std::uint16_t;
+		using payload_size_t = std::uint32_t;
+
+		constexpr std::size_t header_size = sizeof(magic) + sizeof(type_index_t);
+		constexpr std::size_t record_header_size = sizeof(timestamp_t) + sizeof(type_index_t) + sizeof(payload_size_t);
+
+		template <typename T>
+		void Append(std::vector<std::byte> &out, T value)
+		{
+			auto const bytes = reinterpret_cast<const std::byte *>(&value);
+			out.insert(out.end(), bytes, bytes + sizeof(T));
+		}
+
+		template <typename T>
+		T Extract(const std::byte *in) noexcept
+		{
+			T value;
+			std::memcpy(&value, in, sizeof(T));
+			return value;
+		}
+
+	} //ns Private::Capture
+
+} //ns Ctoolhu::Event
+
+#endif //file guard
@@ -78,6 +78,32 @@ namespace Ctoolhu::Event {
 			return conn;
 		}
 
+		//subscribes a member handler to a stateful event with given key
+		template <KeyedEvent Event, typename T>
+		connection_t Subscribe(const event_key_t<Event> &key, T *obj, void (T::*handler)(Event *))
+		{
+			auto conn = Private::SingleAggregator<Event>::Instance().Subscribe(key,
+				[obj, handler](Event *e) {
+					(obj->*handler)(e);
+				}
+			);
+			_connections.push_back(conn);
+			return conn;
+		}
+
+		//subscribes a generic handler to an event with given key
+		template <KeyedEvent Event>
+		connection_t Subscribe(const event_key_t<Event> &key, auto &&handler)
+		{
+			auto conn = Private::SingleAggregator<Event>::Instance().Subscribe(key,
+				[handler = std::forward<decltype(handler)>(handler)](Event *e) {
+					handler(e);
+				}
+			);
+			_connections.push_back(conn);
+			return conn;
+		}
+
 		//unsubscribes custom handler by connection handle returned by Subscribe
 		void Unsubscribe(const connection_t &conn)
 		{
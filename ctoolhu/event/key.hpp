@@ -0,0 +1,52 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_event_key_included_
+#define _ctoolhu_event_key_included_
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace Ctoolhu::Event {
+
+	//Trait extracting the key from an event, which enables keyed subscriptions for the event type.
+	//Specialize it for events that concern one particular entity, e.g.
+	//
+	//	template <>
+	//	struct EventKey<LessonMoved> {
+	//		static auto get(const LessonMoved &e) noexcept { return e.lessonId; }
+	//	};
+	//
+	//The key must be hashable by std::hash, unless the specialization provides its own hasher as 'hash_t'.
+	template <class Event>
+	struct EventKey;
+
+	template <class Event>
+	concept KeyedEvent = requires(const Event &e) {
+		EventKey<Event>::get(e);
+	};
+
+	template <KeyedEvent Event>
+	using event_key_t = std::decay_t<decltype(EventKey<Event>::get(std::declval<const Event &>()))>;
+
+	namespace Private {
+
+		template <class Event>
+		struct EventKeyHash {
+			using type = std::hash<event_key_t<Event>>;
+		};
+
+		template <class Event> requires requires { typename EventKey<Event>::hash_t; }
+		struct EventKeyHash<Event> {
+			using type = typename EventKey<Event>::hash_t;
+		};
+
+		template <KeyedEvent Event>
+		using event_key_hash_t = typename EventKeyHash<Event>::type;
+
+	} //ns Private
+
+} //ns Ctoolhu::Event
+
+#endif //file guard
@@ -0,0 +1,206 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_event_recorder_included_
+#define _ctoolhu_event_recorder_included_
+
+#include "capture.hpp"
+#include "free_subscriber.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Ctoolhu::Event {
+
+	//Captures all events of given types fired during its lifetime into an append-only binary log,
+	//which can be replayed by Replayer instantiated with the same event types in the same order.
+	//The firing thread only serializes the event into a memory buffer, the file is written by a background thread.
+	//When the buffer reaches its limit, firing threads wait for the writer, so that no event is lost.
+	//Firing an event whose serialized payload exceeds payload_size_t throws std::length_error, without recording it.
+	template <SerializableEvent... Events>
+	class Recorder {
+
+		static_assert(sizeof...(Events) > 0, "nothing to record");
+		static_assert(sizeof...(Events) <= std::numeric_limits<Private::Capture::type_index_t>::max(), "too many event types");
+
+		using clock_t = std::chrono::steady_clock;
+
+	  public:
+
+		static constexpr std::size_t default_buffer_limit{64 << 20};
+
+		//throws std::runtime_error if the file can't be opened
+		explicit Recorder(const std::string &fileName, std::size_t bufferLimit = default_buffer_limit)
+			: _state{std::make_shared<State>(fileName, bufferLimit)}
+		{
+			_writer = std::thread{&State::Write, _state.get()};
+			try {
+				_subscriber.emplace();
+				subscribe(std::index_sequence_for<Events...>{});
+			}
+			catch (...) {
+				stop();
+				throw;
+			}
+		}
+
+		Recorder(const Recorder &) = delete;
+		Recorder &operator=(const Recorder &) = delete;
+		Recorder(Recorder &&) = delete;
+		Recorder &operator=(Recorder &&) = delete;
+
+		//stops recording and writes out all recorded events (use Close to learn about write errors)
+		~Recorder()
+		{
+			if (_writer.joinable())
+				stop();
+		}
+
+		//Stops recording and writes out all recorded events.
+		//Throws std::runtime_error if the log couldn't be written completely.
+		void Close()
+		{
+			if (_writer.joinable())
+				stop();
+
+			if (Failed())
+				throw std::runtime_error("can't write event capture file " + _state->fileName);
+		}
+
+		//whether writing the log has failed (the events recorded since are lost)
+		bool Failed() const noexcept
+		{
+			return _state->failed.load(std::memory_order_acquire);
+		}
+
+	  private:
+
+		//Shared with the event handlers, so that a handler still running in another thread when the recorder is destroyed
+		//finds the state alive (and drops the event as recorded too late).
+		struct State {
+
+			State(const std::string &name, std::size_t limit)
+				: fileName{name}, file{name, std::ios::binary | std::ios::trunc}, bufferLimit{limit}
+			{
+				if (!file)
+					throw std::runtime_error("can't open event capture file " + fileName);
+
+				file.write(Private::Capture::magic.data(), Private::Capture::magic.size());
+				auto const typeCount = static_cast<Private::Capture::type_index_t>(sizeof...(Events));
+				file.write(reinterpret_cast<const char *>(&typeCount), sizeof(typeCount));
+				startTime = clock_t::now();
+			}
+
+			template <std::size_t Index, class Event>
+			void Record(const Event &e)
+			{
+				using namespace Private::Capture;
+
+				auto const time = static_cast<timestamp_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_t::now() - startTime).count());
+				bool wasEmpty;
+				{
+					std::unique_lock lock{mutex};
+					drained.wait(lock, [this]() { return buffer.size() < bufferLimit || done; });
+					if (done)
+						return;
+
+					wasEmpty = buffer.empty();
+					auto const recordPos = buffer.size();
+					Append(buffer, time);
+					Append(buffer, static_cast<type_index_t>(Index));
+					auto const sizePos = buffer.size();
+					Append(buffer, payload_size_t{0});
+					EventSerializer<Event>::Write(e, buffer);
+					auto const payloadSize = buffer.size() - sizePos - sizeof(payload_size_t);
+					if (payloadSize > std::numeric_limits<payload_size_t>::max()) {
+						buffer.resize(recordPos);
+						throw std::length_error("event too large for the event capture");
+					}
+					auto const size = static_cast<payload_size_t>(payloadSize);
+					std::memcpy(buffer.data() + sizePos, &size, sizeof(size));
+				}
+				if (wasEmpty)
+					changed.notify_one(); //otherwise the writer is busy and will pick the data up without being woken
+			}
+
+			//writes out the buffered records, swapping the buffers so that recording isn't blocked by the file output
+			void Write()
+			{
+				std::vector<std::byte> pending;
+				std::unique_lock lock{mutex};
+				while (true) {
+					changed.wait(lock, [this]() {
+						return !buffer.empty() || done;
+					});
+					if (buffer.empty())
+						break; //done and nothing left
+
+					pending.swap(buffer);
+					lock.unlock();
+					drained.notify_all();
+					if (!failed.load(std::memory_order_relaxed)) {
+						file.write(reinterpret_cast<const char *>(pending.data()), static_cast<std::streamsize>(pending.size()));
+						if (!file)
+							failed.store(true, std::memory_order_release); //the following records are just discarded
+					}
+					pending.clear();
+					lock.lock();
+				}
+				file.flush();
+				if (!file)
+					failed.store(true, std::memory_order_release);
+			}
+
+			std::string const fileName;
+			std::ofstream file;
+			clock_t::time_point startTime;
+			std::size_t const bufferLimit;
+
+			std::vector<std::byte> buffer;
+			bool done{false};
+			std::mutex mutex;
+			std::condition_variable changed;	//there are records to write or recording is done
+			std::condition_variable drained;	//the buffer was taken by the writer
+			std::atomic<bool> failed{false};
+		};
+
+		template <std::size_t... Indices>
+		void subscribe(std::index_sequence<Indices...>)
+		{
+			(_subscriber->template Subscribe<Events>([state = _state](Events *e) {
+				state->template Record<Indices>(*e);
+			}), ...);
+		}
+
+		void stop()
+		{
+			_subscriber.reset();
+			{
+				std::lock_guard lock{_state->mutex};
+				_state->done = true;
+			}
+			_state->changed.notify_one();
+			_state->drained.notify_all();
+			_writer.join();
+		}
+
+		std::shared_ptr<State> _state;
+		std::thread _writer;
+		std::optional<FreeSubscriber> _subscriber;
+	};
+
+} //ns Ctoolhu::Event
+
+#endif //file guard
@@ -0,0 +1,105 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_event_replayer_included_
+#define _ctoolhu_event_replayer_included_
+
+#include "capture.hpp"
+#include "firer.hpp"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace Ctoolhu::Event {
+
+	enum class ReplayPace {
+		Unthrottled,	//fire the events as fast as possible
+		Recorded		//fire the events with the same timing as they were recorded
+	};
+
+	//Fires again the events captured by Recorder instantiated with the same event types in the same order.
+	//The log is memory-mapped, so the replay doesn't pay for file reading and can be repeated for benchmarking.
+	template <SerializableEvent... Events>
+	class Replayer {
+
+		using clock_t = std::chrono::steady_clock;
+
+	  public:
+
+		explicit Replayer(const std::string &fileName)
+			: _file{fileName.c_str(), boost::interprocess::read_only}
+			, _region{_file, boost::interprocess::read_only}
+		{
+			using namespace Private::Capture;
+
+			_log = {static_cast<const std::byte *>(_region.get_address()), _region.get_size()};
+			if (_log.size() < header_size
+				|| std::memcmp(_log.data(), magic.data(), magic.size()) != 0
+				|| Extract<type_index_t>(_log.data() + magic.size()) != sizeof...(Events))
+			{
+				throw std::runtime_error("not an event capture of the expected event types: " + fileName);
+			}
+		}
+
+		//Fires all events in the log in the recorded order, returns the number of fired events.
+		//Throws std::runtime_error if the log is truncated.
+		std::size_t Replay(ReplayPace pace = ReplayPace::Unthrottled) const
+		{
+			using namespace Private::Capture;
+
+			std::size_t count{0};
+			auto const startTime = clock_t::now();
+			auto pos = header_size;
+			for (; pos + record_header_size <= _log.size(); ++count) {
+				auto const record = _log.data() + pos;
+				auto const time = Extract<timestamp_t>(record);
+				auto const typeIndex = Extract<type_index_t>(record + sizeof(timestamp_t));
+				auto const size = Extract<payload_size_t>(record + sizeof(timestamp_t) + sizeof(type_index_t));
+				pos += record_header_size;
+				if (pos + size > _log.size())
+					throw std::runtime_error("truncated event capture");
+
+				if (pace == ReplayPace::Recorded)
+					std::this_thread::sleep_until(startTime + std::chrono::nanoseconds{time});
+
+				fire(typeIndex, _log.subspan(pos, size), std::index_sequence_for<Events...>{});
+				pos += size;
+			}
+			if (pos != _log.size())
+				throw std::runtime_error("truncated event capture"); //ends inside a record header
+
+			return count;
+		}
+
+	  private:
+
+		template <std::size_t... Indices>
+		static void fire(std::size_t typeIndex, std::span<const std::byte> payload, std::index_sequence<Indices...>)
+		{
+			bool const known = ((typeIndex == Indices && (fire<Events>(payload), true)) || ...);
+			if (!known)
+				throw std::runtime_error("unknown event type in event capture");
+		}
+
+		template <class Event>
+		static void fire(std::span<const std::byte> payload)
+		{
+			auto e = EventSerializer<Event>::Read(payload);
+			Fire(e);
+		}
+
+		boost::interprocess::file_mapping _file;
+		boost::interprocess::mapped_region _region;
+		std::span<const std::byte> _log;
+	};
+
+} //ns Ctoolhu::Event
+
+#endif //file guard
@@ -0,0 +1,215 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_memory_arena_included_
+#define _ctoolhu_memory_arena_included_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Ctoolhu::Memory {
+
+	//Monotonic allocator bump-allocating from a chain of blocks.
+	//Individual allocations are never freed, all of them are released at once by reset() or by rewinding to a mark.
+	//The blocks are kept for reuse until release(), so an arena reset every iteration stops allocating after the first one.
+	class Arena {
+
+		struct Block {
+			Block *next;
+			std::size_t size;
+		};
+
+	  public:
+
+		static constexpr std::size_t default_block_size{64 * 1024};
+
+		//state of the arena to return to by rewind
+		struct Mark {
+			Block *block;
+			std::uintptr_t cursor;
+		};
+
+		explicit Arena(std::size_t blockSize = default_block_size) noexcept
+			: _blockSize{blockSize} {}
+
+		Arena(const Arena &) = delete;
+		Arena &operator=(const Arena &) = delete;
+
+		~Arena()
+		{
+			release();
+		}
+
+		//throws std::bad_alloc if a new block can't be allocated
+		void *allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+		{
+			auto const aligned = alignUp(_cursor, alignment);
+			if (_current && aligned <= _end && size <= _end - aligned) {
+				_cursor = aligned + size;
+				return reinterpret_cast<void *>(aligned);
+			}
+			return allocateInNextBlock(size, alignment);
+		}
+
+		//constructs an object in the arena - it is never destructed, so only trivially destructible types are allowed
+		template <class T, class... Args>
+		T *create(Args &&... args)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "arena doesn't call destructors");
+			return ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		Mark mark() const noexcept
+		{
+			return {_current, _cursor};
+		}
+
+		//frees everything allocated since the mark was taken
+		void rewind(Mark m) noexcept
+		{
+			_current = m.block;
+			_cursor = m.cursor;
+			_end = _current ? begin(_current) + _current->size : 0;
+		}
+
+		//frees everything allocated from the arena, but keeps the blocks for reuse
+		void reset() noexcept
+		{
+			rewind({nullptr, 0});
+		}
+
+		//frees everything allocated from the arena and returns the blocks to the system
+		void release() noexcept
+		{
+			while (_first) {
+				auto block = _first;
+				_first = block->next;
+				::operator delete(block);
+			}
+			reset();
+		}
+
+		//total size of the blocks held
+		std::size_t capacity() const noexcept
+		{
+			std::size_t total{0};
+			for (auto block = _first; block; block = block->next)
+				total += block->size;
+			return total;
+		}
+
+	  private:
+
+		static std::uintptr_t alignUp(std::uintptr_t address, std::size_t alignment) noexcept
+		{
+			return (address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+		}
+
+		static std::uintptr_t begin(Block *block) noexcept
+		{
+			return reinterpret_cast<std::uintptr_t>(block + 1);
+		}
+
+		//moves on to the next kept block, or inserts a new one if there is none big enough
+		void *allocateInNextBlock(std::size_t size, std::size_t alignment)
+		{
+			auto const needed = size + alignment - 1;
+			auto &link = _current ? _current->next : _first;
+			if (!link || link->size < needed) {
+				auto const blockSize = std::max(_blockSize, needed);
+				auto block = static_cast<Block *>(::operator new(sizeof(Block) + blockSize));
+				link = ::new (block) Block{link, blockSize};
+			}
+			_current = link;
+			_end = begin(_current) + _current->size;
+			auto const aligned = alignUp(begin(_current), alignment);
+			_cursor = aligned + size;
+			return reinterpret_cast<void *>(aligned);
+		}
+
+		std::size_t _blockSize;
+		Block *_first{nullptr};
+		Block *_current{nullptr};
+		std::uintptr_t _cursor{0};
+		std::uintptr_t _end{0};
+	};
+
+	//adapts the arena for use with std::pmr containers
+	class ArenaResource : public std::pmr::memory_resource {
+
+	  public:
+
+		explicit ArenaResource(Arena &arena) noexcept
+			: _arena{arena} {}
+
+	  private:
+
+		void *do_allocate(std::size_t bytes, std::size_t alignment) override
+		{
+			return _arena.allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void *, std::size_t, std::size_t) noexcept override {}
+
+		bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+		{
+			return this == &other;
+		}
+
+		Arena &_arena;
+	};
+
+	//Scope of the calling thread's scratch arena - everything allocated from it within the scope is freed when the scope ends.
+	//Scopes can be nested, e.g.
+	//
+	//	ScratchArena scratch;
+	//	std::pmr::vector<int> candidates{scratch.resource()};
+	//
+	class ScratchArena {
+
+	  public:
+
+		ScratchArena() noexcept
+			: _arena{threadArena()}
+			, _mark{_arena.mark()}
+			, _resource{_arena} {}
+
+		ScratchArena(const ScratchArena &) = delete;
+		ScratchArena &operator=(const ScratchArena &) = delete;
+
+		~ScratchArena()
+		{
+			_arena.rewind(_mark);
+		}
+
+		Arena &arena() noexcept
+		{
+			return _arena;
+		}
+
+		std::pmr::memory_resource *resource() noexcept
+		{
+			return &_resource;
+		}
+
+	  private:
+
+		static Arena &threadArena() noexcept
+		{
+			thread_local Arena arena;
+			return arena;
+		}
+
+		Arena &_arena;
+		Arena::Mark _mark;
+		ArenaResource _resource;
+	};
+
+} //ns
+
+#endif //file guard
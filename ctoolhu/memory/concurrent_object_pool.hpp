@@ -0,0 +1,347 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_memory_concurrent_object_pool_included_
+#define _ctoolhu_memory_concurrent_object_pool_included_
+
+#include "object_pool.hpp"
+#include "object_pool_deleter.hpp"
+#include "slab_pool.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Ctoolhu::Memory {
+
+	namespace Private {
+
+		class Depot;
+
+		//thread-local cache of free chunks of one concurrent pool
+		struct Magazine {
+
+			static constexpr std::size_t capacity{64};
+			static constexpr std::size_t batch{capacity / 2}; //number of chunks exchanged with the depot at once
+
+			Magazine() = default;
+			Magazine(const Magazine &) = delete;
+			Magazine &operator=(const Magazine &) = delete;
+
+			//returns the cached chunks to the depot when the thread exits, unless the pool is gone already
+			~Magazine();
+
+			std::weak_ptr<Depot> depot;
+			std::array<void *, capacity> chunks;
+			std::atomic<std::size_t> count{0}; //written only by the owning thread, but read by the depot for statistics
+		};
+
+		//shared store of free chunks of a concurrent pool, from which the threads refill their magazines and to which they spill them
+		class Depot {
+
+		  public:
+
+			Depot(std::size_t chunkSize, std::size_t chunkAlign)
+				: _storage{chunkSize, chunkAlign} {}
+
+			Depot(const Depot &) = delete;
+			Depot &operator=(const Depot &) = delete;
+
+			//moves up to 'count' free chunks to 'out', allocating new ones if there aren't enough free ones
+			//returns the number of chunks moved, which is less than requested only if the allocation failed
+			std::size_t Refill(void **out, std::size_t count) noexcept
+			{
+				std::lock_guard lock{_mutex};
+				std::size_t moved{0};
+				for (; moved < count && _free; ++moved) {
+					out[moved] = _free;
+					_free = *static_cast<void **>(_free);
+					--_freeCount;
+				}
+				for (; moved < count; ++moved) {
+					out[moved] = _storage.malloc();
+					if (out[moved] == nullptr)
+						break;
+				}
+				return moved;
+			}
+
+			//takes back given chunks
+			void Spill(void *const *chunks, std::size_t count) noexcept
+			{
+				if (count == 0)
+					return;
+
+				//link the chunks outside the lock, so that splicing them to the free list is constant
+				link(chunks, count);
+				std::lock_guard lock{_mutex};
+				splice(chunks, count);
+			}
+
+			//makes the free chunks cached by the magazine known to the depot
+			void Attach(Magazine &magazine)
+			{
+				std::lock_guard lock{_mutex};
+				_magazines.push_back(&magazine);
+			}
+
+			//takes back the chunks cached by the magazine of a thread which ends
+			void Detach(Magazine &magazine) noexcept
+			{
+				std::lock_guard lock{_mutex};
+				std::erase(_magazines, &magazine);
+				if (auto const count = magazine.count.load(std::memory_order_relaxed); count > 0) {
+					link(magazine.chunks.data(), count); //under the lock, as the pool may be just walking the magazines
+					splice(magazine.chunks.data(), count);
+				}
+			}
+
+			//Calls the function for each chunk in use by an object, i.e. neither free in the depot nor cached by a thread.
+			//The threads mustn't use the pool meanwhile.
+			template <class Func>
+			void ForEachLive(Func &&f) const
+			{
+				std::vector<void *> live;
+				{
+					std::lock_guard lock{_mutex};
+					std::vector<const void *> free;
+					for (auto chunk = _free; chunk; chunk = *static_cast<void **>(chunk))
+						free.push_back(chunk);
+					for (auto magazine : _magazines)
+						free.insert(free.end(), magazine->chunks.begin(), magazine->chunks.begin() + magazine->count.load(std::memory_order_relaxed));
+
+					std::sort(free.begin(), free.end());
+					_storage.ForEachLive([&free, &live](void *chunk) {
+						if (!std::binary_search(free.begin(), free.end(), chunk))
+							live.push_back(chunk);
+					});
+				}
+				for (auto chunk : live)
+					f(chunk);
+			}
+
+			//Statistics of the objects in use, i.e. of the chunks neither free in the depot nor cached by a thread.
+			//The peak counts the cached chunks too, as it is tracked only for the chunks taken from the depot.
+			PoolStats stats() const
+			{
+				std::lock_guard lock{_mutex};
+				auto result = _storage.stats();
+				result.live -= _freeCount;
+				for (auto magazine : _magazines)
+					result.live -= std::min(result.live, magazine->count.load(std::memory_order_relaxed)); //a count may be just being refilled
+				return result;
+			}
+
+		  private:
+
+			static void link(void *const *chunks, std::size_t count) noexcept
+			{
+				for (std::size_t i{1}; i < count; ++i)
+					*static_cast<void **>(chunks[i - 1]) = chunks[i];
+			}
+
+			//prepends the linked chunks to the free list
+			void splice(void *const *chunks, std::size_t count) noexcept
+			{
+				*static_cast<void **>(chunks[count - 1]) = _free;
+				_free = chunks[0];
+				_freeCount += count;
+			}
+
+			mutable std::mutex _mutex;
+			void *_free{nullptr}; //intrusive list of free chunks
+			std::size_t _freeCount{0};
+			std::vector<Magazine *> _magazines; //of the threads which have used the pool
+			SlabStorage _storage; //chunks are never freed to the storage, they go to the free list instead
+		};
+
+		inline Magazine::~Magazine()
+		{
+			if (auto d = depot.lock())
+				d->Detach(*this);
+		}
+
+		//magazines of the current thread for all concurrent pools it has used
+		class MagazineCache {
+
+		  public:
+
+			static MagazineCache &Instance() noexcept
+			{
+				thread_local MagazineCache cache;
+				return cache;
+			}
+
+			//unique among the pools of all types, whose magazines share the cache
+			static std::uint64_t NewPoolId() noexcept
+			{
+				static std::atomic<std::uint64_t> lastId{0};
+				return ++lastId;
+			}
+
+			Magazine &Get(std::uint64_t poolId, const std::shared_ptr<Depot> &depot)
+			{
+				if (poolId == _lastPoolId)
+					return *_last;
+
+				auto it = _magazines.find(poolId);
+				if (it == _magazines.end()) {
+					std::erase_if(_magazines, [](auto const &m) { return m.second.depot.expired(); }); //forget pools that don't exist anymore
+					it = _magazines.try_emplace(poolId).first;
+					try {
+						depot->Attach(it->second);
+					}
+					catch (...) {
+						_magazines.erase(it);
+						throw;
+					}
+					it->second.depot = depot;
+				}
+				_lastPoolId = poolId;
+				_last = &it->second;
+				return *_last;
+			}
+
+		  private:
+
+			std::unordered_map<std::uint64_t, Magazine> _magazines; //by pool id, which is never reused unlike pool address
+			std::uint64_t _lastPoolId{0};
+			Magazine *_last{nullptr};
+		};
+
+		//allocates from the thread's magazine, so that the shared depot is locked only once per batch
+		template <class T>
+		class ConcurrentPoolStorage {
+
+		  public:
+
+			ConcurrentPoolStorage()
+				: _depot{std::make_shared<Depot>(sizeof(T), alignof(T))} {}
+
+			ConcurrentPoolStorage(const ConcurrentPoolStorage &) = delete;
+			ConcurrentPoolStorage &operator=(const ConcurrentPoolStorage &) = delete;
+
+			//destroys the objects still alive, like SlabPool
+			~ConcurrentPoolStorage()
+			{
+				if constexpr (!std::is_trivially_destructible_v<T>) {
+					_depot->ForEachLive([](void *chunk) {
+						static_cast<T *>(chunk)->~T();
+					});
+				}
+			}
+
+			T *malloc()
+			{
+				auto &mag = magazine();
+				auto count = mag.count.load(std::memory_order_relaxed);
+				if (count == 0) {
+					count = _depot->Refill(mag.chunks.data(), Magazine::batch);
+					if (count == 0)
+						return nullptr;
+				}
+				mag.count.store(--count, std::memory_order_relaxed);
+				return static_cast<T *>(mag.chunks[count]);
+			}
+
+			//the chunk goes to the magazine of the calling thread, which needn't be the allocating one
+			void free(T *ptr)
+			{
+				auto &mag = magazine();
+				auto count = mag.count.load(std::memory_order_relaxed);
+				if (count == Magazine::capacity) {
+					count -= Magazine::batch;
+					_depot->Spill(mag.chunks.data() + count, Magazine::batch);
+				}
+				mag.chunks[count] = ptr;
+				mag.count.store(count + 1, std::memory_order_relaxed);
+			}
+
+			void destroy(T *obj)
+			{
+				obj->~T();
+				free(obj);
+			}
+
+			PoolStats stats() const
+			{
+				return _depot->stats();
+			}
+
+		  private:
+
+			Magazine &magazine()
+			{
+				return MagazineCache::Instance().Get(_id, _depot);
+			}
+
+			std::shared_ptr<Depot> _depot;
+			const std::uint64_t _id{MagazineCache::NewPoolId()};
+		};
+
+	} //ns Private
+
+	//Thread-safe counterpart of ObjectPool.
+	//Each thread allocates from and frees to its own cache of free slots, which is refilled from
+	//or spilled to the shared depot in batches, so threads don't contend for the pool on every allocation.
+	//Objects may be freed by any thread.
+	//Objects still alive when the pool is destroyed are destroyed too, which must not happen while other threads use the pool.
+	template <
+		class T,
+		template <class> class MallocErrorsPolicy = PoolIgnoreMallocErrorsPolicy //ignore errors by default
+	>
+	class ConcurrentObjectPool : protected MallocErrorsPolicy<Private::ConcurrentPoolStorage<T>> {
+
+		using deleter_t = ObjectPoolDeleter<T, Private::ConcurrentPoolStorage<T>>;
+
+	  public:
+
+		using unique_ptr_t = std::unique_ptr<T, deleter_t &>;
+
+		ConcurrentObjectPool() : _deleter(this)
+		{
+			Private::SinglePoolRegistry::Instance().Register(this, typeid(T));
+		}
+
+		~ConcurrentObjectPool()
+		{
+			Private::SinglePoolRegistry::Instance().Unregister(this);
+		}
+
+		template <class... Args>
+		unique_ptr_t make_unique(Args &&... args)
+		{
+			auto ptr = this->malloc(); //errors are handled according to the policy template
+			if (ptr == nullptr)
+				return unique_ptr_t{nullptr, _deleter};
+
+			try {
+				return unique_ptr_t{::new (ptr) T(std::forward<Args>(args)...), _deleter};
+			}
+			catch (...) {
+				this->free(ptr); //the object was never constructed
+				throw;
+			}
+		}
+
+		//can be called from any thread, but the numbers needn't be mutually consistent while the pool is in use
+		PoolStats stats() const
+		{
+			return Private::ConcurrentPoolStorage<T>::stats();
+		}
+
+	  private:
+
+		deleter_t _deleter;
+	};
+
+} //ns
+
+#endif //file guard
@@ -5,63 +5,224 @@
 #define _ctoolhu_memory_object_pool_included_
 
 #include "object_pool_deleter.hpp"
-#include <boost/pool/object_pool.hpp>
-#include <exception>
+#include "pool_allocator.hpp"
+#include "pool_registry.hpp"
+#include "pooled_ptr.hpp"
+#include "slab_pool.hpp"
+#include <cstddef>
 #include <memory>
+#include <new>
+#include <utility>
 
 namespace Ctoolhu::Memory {
 
-	template <class T>
-	class PoolIgnoreMallocErrorsPolicy : protected boost::object_pool<T> {
+	//policies for handling allocation failures of the underlying pool (anything providing malloc returning nullptr on failure)
+
+	//the pools then create empty pointers when the allocation fails
+	template <class Pool>
+	class PoolIgnoreMallocErrorsPolicy : protected Pool {
 
 	  protected:
 
 		auto malloc()
 		{
-			return boost::object_pool<T>::malloc();
+			return Pool::malloc();
+		}
+
+		bool reserve(std::size_t count)
+		{
+			return Pool::reserve(count);
 		}
 	};
 
-	template <class T>
-	class PoolThrowOnMallocErrorsPolicy : protected boost::object_pool<T> {
+	template <class Pool>
+	class PoolThrowOnMallocErrorsPolicy : protected Pool {
 
 	  protected:
 
 		auto malloc()
 		{
-			auto ptr = boost::object_pool<T>::malloc();
+			auto ptr = Pool::malloc();
 			if (ptr == nullptr)
 				throw std::bad_alloc();
 
 			return ptr;
 		}
+
+		bool reserve(std::size_t count)
+		{
+			if (!Pool::reserve(count))
+				throw std::bad_alloc();
+
+			return true;
+		}
 	};
 
-	//Extension of boost::object_pool that can used to create unique_ptr of T without worrying about the deleter
+	namespace Private {
+
+		//allocator of ObjectPool::make_shared, whose copy in the control block keeps the resource alive after the pool is gone
+		template <class T>
+		class SharedPoolAllocator : public PoolAllocator<T> {
+
+		  public:
+
+			explicit SharedPoolAllocator(std::shared_ptr<PoolResource> resource)
+				: PoolAllocator<T>{*resource}, _resource{std::move(resource)} {}
+
+			template <class U>
+			SharedPoolAllocator(const SharedPoolAllocator<U> &src)
+				: PoolAllocator<T>{src}, _resource{src._resource} {}
+
+		  private:
+
+			template <class U>
+			friend class SharedPoolAllocator;
+
+			std::shared_ptr<PoolResource> _resource;
+		};
+
+	} //ns Private
+
+	//Pool of objects of type T that can be used to create unique_ptr of T without worrying about the deleter.
+	//The pool can be moved without invalidating the pointers it has created.
+	//A moved-from pool is empty and unlimited, and creates its memory anew when used.
 	template <
 		class T,
 		template <class> class MallocErrorsPolicy = PoolIgnoreMallocErrorsPolicy //ignore errors by default
 	>
-	class ObjectPool : protected MallocErrorsPolicy<T> {
+	class ObjectPool {
 
 		using deleter_t = ObjectPoolDeleter<T>;
 
+		//kept on the heap, so that the deleter and the slabs referenced by the created pointers don't move with the pool
+		class Storage : public MallocErrorsPolicy<SlabPool<T>> {
+
+			using base_t = MallocErrorsPolicy<SlabPool<T>>;
+
+		  public:
+
+			Storage() : deleter(this)
+			{
+				Private::SinglePoolRegistry::Instance().Register<SlabPool<T>>(this, typeid(T));
+			}
+
+			~Storage()
+			{
+				Private::SinglePoolRegistry::Instance().Unregister(static_cast<SlabPool<T> *>(this));
+			}
+
+			using base_t::malloc;
+			using base_t::reserve;
+			using SlabPool<T>::free;
+			using SlabPool<T>::shrink;
+			using SlabPool<T>::stats;
+			using SlabPool<T>::limit;
+			using SlabPool<T>::set_limit;
+
+			deleter_t deleter;
+			std::shared_ptr<PoolResource> sharedResource{std::make_shared<PoolResource>()}; //for objects created by make_shared, shared with their control blocks
+		};
+
 	  public:
 
 		using unique_ptr_t = std::unique_ptr<T, deleter_t &>;
+		using pooled_ptr_t = PooledPtr<T>;
 
-		ObjectPool() noexcept : _deleter(this) {}
+		ObjectPool()
+			: _storage{std::make_unique<Storage>()} {}
 
 		template <class... Args>
 		unique_ptr_t make_unique(Args &&... args)
 		{
-			auto ptr = this->malloc(); //errors are handled according to the policy template
-			return unique_ptr_t{::new (ptr) T(std::forward<Args>(args)...), _deleter};
+			auto &s = storage();
+			auto ptr = s.malloc(); //errors are handled according to the policy template
+			if (ptr == nullptr)
+				return unique_ptr_t{nullptr, s.deleter};
+
+			return unique_ptr_t{construct(s, ptr, std::forward<Args>(args)...), s.deleter};
 		}
 
+		//creates an object owned by a pointer of raw pointer size (see PooledPtr)
+		template <class... Args>
+		pooled_ptr_t make_pooled(Args &&... args)
+		{
+			auto &s = storage();
+			auto ptr = s.malloc(); //errors are handled according to the policy template
+			if (ptr == nullptr)
+				return nullptr;
+
+			return pooled_ptr_t{construct(s, ptr, std::forward<Args>(args)...)};
+		}
+
+		//Creates the object together with its control block in one chunk of the pool
+		//(allocation errors always throw std::bad_alloc as required of allocators).
+		//The control block shares the ownership of the memory it comes from, so the shared and weak pointers may outlive the pool.
+		template <class... Args>
+		std::shared_ptr<T> make_shared(Args &&... args)
+		{
+			return std::allocate_shared<T>(Private::SharedPoolAllocator<T>{storage().sharedResource}, std::forward<Args>(args)...);
+		}
+
+		//preallocates memory for given number of objects in total
+		//returns false on failure (errors are handled according to the policy template)
+		bool reserve(std::size_t count)
+		{
+			return storage().reserve(count);
+		}
+
+		//releases memory not used by any object
+		void shrink() noexcept
+		{
+			if (_storage) {
+				_storage->shrink();
+				_storage->sharedResource->shrink();
+			}
+		}
+
+		//statistics of objects created by make_unique and make_pooled (make_shared uses separate memory)
+		PoolStats stats() const noexcept
+		{
+			return _storage ? _storage->stats() : PoolStats{};
+		}
+
+		std::size_t limit() const noexcept
+		{
+			return _storage ? _storage->limit() : unlimited;
+		}
+
+		//limits the number of objects created by make_unique and make_pooled alive at once
+		//(creating more is an allocation error handled according to the policy template)
+		void set_limit(std::size_t maxLive = unlimited)
+		{
+			storage().set_limit(maxLive);
+		}
+
+		static constexpr std::size_t unlimited{SlabPool<T>::unlimited};
+
 	  private:
 
-		deleter_t _deleter;
+		//constructs the object in the chunk, which is freed if the constructor throws
+		template <class... Args>
+		static T *construct(Storage &s, T *ptr, Args &&... args)
+		{
+			try {
+				return ::new (ptr) T(std::forward<Args>(args)...);
+			}
+			catch (...) {
+				s.free(ptr);
+				throw;
+			}
+		}
+
+		Storage &storage()
+		{
+			if (!_storage)
+				_storage = std::make_unique<Storage>(); //moved from
+
+			return *_storage;
+		}
+
+		std::unique_ptr<Storage> _storage;
 	};
 
 } //ns
@@ -4,16 +4,20 @@
 #ifndef _ctoolhu_memory_object_pool_deleter_included_
 #define _ctoolhu_memory_object_pool_deleter_included_
 
-#include <boost/pool/object_pool.hpp>
+#include "slab_pool.hpp"
 
 namespace Ctoolhu::Memory {
 
-	template <class T>
+	//destroys the object and returns its memory to the pool it came from
+	template <
+		class T,
+		class Pool = SlabPool<T>
+	>
 	class ObjectPoolDeleter {
 
 	  public:
 
-		explicit ObjectPoolDeleter(boost::object_pool<T> *pool) noexcept
+		explicit ObjectPoolDeleter(Pool *pool) noexcept
 			: _pool{pool} {}
 
 		void operator()(T *obj)
@@ -23,7 +27,7 @@ namespace Ctoolhu::Memory {
 
 	  private:
 
-		boost::object_pool<T> *_pool;
+		Pool *_pool;
 	};
 
 } //ns
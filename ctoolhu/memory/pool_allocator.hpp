@@ -0,0 +1,113 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_memory_pool_allocator_included_
+#define _ctoolhu_memory_pool_allocator_included_
+
+#include "slab_pool.hpp"
+#include <cstddef>
+#include <deque>
+#include <new>
+
+namespace Ctoolhu::Memory {
+
+	//Set of slab storages, one for each size of objects allocated through PoolAllocator.
+	//Like the other pools it isn't thread-safe and must outlive everything allocated from it.
+	class PoolResource {
+
+	  public:
+
+		PoolResource() = default;
+		PoolResource(const PoolResource &) = delete;
+		PoolResource &operator=(const PoolResource &) = delete;
+
+		Private::SlabStorage &Storage(std::size_t size, std::size_t alignment)
+		{
+			for (auto &s : _storages) {
+				if (s.size == size && s.alignment == alignment)
+					return s.storage;
+			}
+			return _storages.emplace_back(size, alignment).storage;
+		}
+
+		//releases the slabs which have no objects in use
+		void shrink() noexcept
+		{
+			for (auto &s : _storages)
+				s.storage.shrink();
+		}
+
+	  private:
+
+		struct SizedStorage {
+
+			SizedStorage(std::size_t size, std::size_t alignment) noexcept
+				: size{size}, alignment{alignment}, storage{size, alignment} {}
+
+			std::size_t size;
+			std::size_t alignment;
+			Private::SlabStorage storage;
+		};
+
+		std::deque<SizedStorage> _storages; //deque doesn't move the elements when growing
+	};
+
+	//Standard allocator taking single objects from the slabs of a PoolResource, e.g. for node-based containers:
+	//
+	//	PoolResource resource;
+	//	std::map<int, Lesson, std::less<>, PoolAllocator<std::pair<const int, Lesson>>> lessons{resource};
+	//
+	//Arrays (e.g. buckets of unordered containers) are allocated by operator new.
+	template <class T>
+	class PoolAllocator {
+
+	  public:
+
+		using value_type = T;
+
+		PoolAllocator(PoolResource &resource)
+			: _resource{&resource}
+			, _storage{&resource.Storage(sizeof(T), alignof(T))} {}
+
+		template <class U>
+		PoolAllocator(const PoolAllocator<U> &src)
+			: PoolAllocator{*src._resource} {}
+
+		T *allocate(std::size_t n)
+		{
+			if (n != 1)
+				return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+
+			auto ptr = _storage->malloc();
+			if (ptr == nullptr)
+				throw std::bad_alloc();
+
+			return static_cast<T *>(ptr);
+		}
+
+		void deallocate(T *ptr, std::size_t n) noexcept
+		{
+			if (n != 1)
+				::operator delete(ptr, std::align_val_t{alignof(T)});
+			else
+				_storage->free(ptr);
+		}
+
+		template <class U>
+		bool operator==(const PoolAllocator<U> &other) const noexcept
+		{
+			return _resource == other._resource;
+		}
+
+	  private:
+
+		template <class U>
+		friend class PoolAllocator;
+
+		PoolResource *_resource;
+		Private::SlabStorage *_storage;
+	};
+
+} //ns
+
+#endif //file guard
@@ -0,0 +1,86 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_memory_pool_registry_included_
+#define _ctoolhu_memory_pool_registry_included_
+
+#include "slab_pool.hpp"
+#include "../singleton/holder.hpp"
+#include <boost/core/demangle.hpp>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace Ctoolhu::Memory {
+
+	struct PoolInfo {
+		std::string type;	//type of the pooled objects
+		PoolStats stats;
+	};
+
+	namespace Private {
+
+		//keeps track of all existing object pools for diagnostics
+		class PoolRegistry {
+
+		  public:
+
+			PoolRegistry(const PoolRegistry &) = delete;
+			PoolRegistry &operator=(const PoolRegistry &) = delete;
+
+			//registers a pool providing stats() of objects of given type
+			template <class Pool>
+			void Register(const Pool *pool, const std::type_info &type)
+			{
+				std::lock_guard lock{_mutex};
+				_pools.emplace(pool, Entry{&type, [](const void *p) {
+					return static_cast<const Pool *>(p)->stats();
+				}});
+			}
+
+			void Unregister(const void *pool) noexcept
+			{
+				std::lock_guard lock{_mutex};
+				_pools.erase(pool);
+			}
+
+			std::vector<PoolInfo> Snapshot() const
+			{
+				std::vector<PoolInfo> result;
+				std::lock_guard lock{_mutex};
+				result.reserve(_pools.size());
+				for (auto const &[pool, entry] : _pools)
+					result.push_back({boost::core::demangle(entry.type->name()), entry.stats(pool)});
+
+				return result;
+			}
+
+		  private:
+
+			friend struct Loki::CreateUsingNew<PoolRegistry>;
+			PoolRegistry() = default;
+
+			struct Entry {
+				const std::type_info *type;
+				PoolStats (*stats)(const void *);
+			};
+
+			std::unordered_map<const void *, Entry> _pools;
+			mutable std::mutex _mutex;
+		};
+
+		using SinglePoolRegistry = Singleton::Holder<PoolRegistry>;
+
+	} //ns Private
+
+	//returns the statistics of all existing object pools
+	inline std::vector<PoolInfo> RegisteredPools()
+	{
+		return Private::SinglePoolRegistry::Instance().Snapshot();
+	}
+
+} //ns
+
+#endif //file guard
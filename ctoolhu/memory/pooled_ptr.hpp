@@ -0,0 +1,87 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_memory_pooled_ptr_included_
+#define _ctoolhu_memory_pooled_ptr_included_
+
+#include "slab_pool.hpp"
+#include <cstddef>
+#include <utility>
+
+namespace Ctoolhu::Memory {
+
+	//Owning pointer to an object created by ObjectPool::make_pooled, with the semantics of unique_ptr.
+	//Unlike ObjectPool::unique_ptr_t it doesn't carry a deleter - the pool is found from the slab the object lives in -
+	//so it is only as big as a raw pointer.
+	template <class T>
+	class PooledPtr {
+
+		static constexpr std::size_t slab_size{Private::SlabStorage::slab_size_for(sizeof(T), alignof(T))};
+
+	  public:
+
+		using element_type = T;
+		using pointer = T *;
+
+		constexpr PooledPtr() noexcept = default;
+		constexpr PooledPtr(std::nullptr_t) noexcept {}
+
+		//takes ownership of an object constructed in memory of a slab pool of T
+		explicit PooledPtr(T *obj) noexcept
+			: _obj{obj} {}
+
+		PooledPtr(PooledPtr &&src) noexcept
+			: _obj{std::exchange(src._obj, nullptr)} {}
+
+		PooledPtr &operator=(PooledPtr &&src) noexcept
+		{
+			reset(std::exchange(src._obj, nullptr));
+			return *this;
+		}
+
+		PooledPtr(const PooledPtr &) = delete;
+		PooledPtr &operator=(const PooledPtr &) = delete;
+
+		~PooledPtr()
+		{
+			reset();
+		}
+
+		T *get() const noexcept { return _obj; }
+		T &operator*() const noexcept { return *_obj; }
+		T *operator->() const noexcept { return _obj; }
+		explicit operator bool() const noexcept { return _obj != nullptr; }
+
+		//gives up the ownership without destroying the object
+		[[nodiscard]] T *release() noexcept
+		{
+			return std::exchange(_obj, nullptr);
+		}
+
+		//destroys the owned object and returns its memory to its pool
+		void reset(T *obj = nullptr) noexcept
+		{
+			if (auto old = std::exchange(_obj, obj)) {
+				old->~T();
+				Private::SlabStorage::OwnerOf(old, slab_size)->free(old);
+			}
+		}
+
+		void swap(PooledPtr &other) noexcept
+		{
+			std::swap(_obj, other._obj);
+		}
+
+		friend bool operator==(const PooledPtr &a, const PooledPtr &b) noexcept = default;
+		friend bool operator==(const PooledPtr &a, std::nullptr_t) noexcept { return !a; }
+
+	  private:
+
+		T *_obj{nullptr};
+	};
+
+	static_assert(sizeof(PooledPtr<int>) == sizeof(int *));
+
+} //ns
+
+#endif //file guard
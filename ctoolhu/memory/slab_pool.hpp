@@ -0,0 +1,332 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_memory_slab_pool_included_
+#define _ctoolhu_memory_slab_pool_included_
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Ctoolhu::Memory {
+
+	struct PoolStats {
+		std::size_t live;			//objects in use
+		std::size_t peak;			//highest number of objects in use at once
+		std::size_t capacity;		//number of objects which fit into the slabs held
+		std::size_t bytes_reserved;	//memory held by the slabs
+	};
+
+	namespace Private {
+
+		class SlabStorage;
+
+		//bookkeeping at the start of each slab
+		struct SlabHeader {
+			SlabStorage *owner;
+			SlabHeader *prev;		//links in the list of slabs with available chunks
+			SlabHeader *next;
+			SlabHeader *nextSlab;	//link in the list of all slabs
+			void *free;				//list of freed chunks
+			std::uint32_t live;		//number of chunks in use
+			std::uint32_t fresh;	//index of the first chunk which has never been used
+		};
+
+		//Untyped storage of fixed-size chunks carved from slabs.
+		//Slabs are aligned to their size, so the slab of any chunk is found by masking the chunk address,
+		//which makes both allocation and deallocation constant regardless of the number of free chunks.
+		class SlabStorage {
+
+		  public:
+
+			static constexpr std::size_t page_size{4096};
+			static constexpr std::size_t min_chunks_per_slab{8};
+
+			SlabStorage(std::size_t chunkSize, std::size_t chunkAlign) noexcept
+				: _chunkSize{chunk_size_for(chunkSize, chunkAlign)}
+				, _chunksOffset{roundUp(sizeof(SlabHeader), chunk_align_for(chunkAlign))}
+				, _slabSize{slab_size_for(chunkSize, chunkAlign)}
+				, _chunksPerSlab{static_cast<std::uint32_t>((_slabSize - _chunksOffset) / _chunkSize)}
+			{
+				assert(std::has_single_bit(chunkAlign) && "alignment must be a power of two");
+			}
+
+			SlabStorage(const SlabStorage &) = delete;
+			SlabStorage &operator=(const SlabStorage &) = delete;
+
+			~SlabStorage()
+			{
+				while (_slabs) {
+					auto slab = _slabs;
+					_slabs = slab->nextSlab;
+					releaseSlab(slab);
+				}
+			}
+
+			static constexpr std::size_t unlimited{std::numeric_limits<std::size_t>::max()};
+
+			//returns nullptr if the limit of chunks in use is reached or if a new slab is needed and can't be allocated
+			void *malloc() noexcept
+			{
+				auto const live = _live.load(std::memory_order_relaxed);
+				if (live >= _limit || (!_available && !addSlab()))
+					return nullptr;
+
+				_live.store(live + 1, std::memory_order_relaxed);
+				if (live + 1 > _peak.load(std::memory_order_relaxed))
+					_peak.store(live + 1, std::memory_order_relaxed);
+
+				auto slab = _available;
+				void *chunk;
+				if (slab->free) {
+					chunk = slab->free;
+					slab->free = *static_cast<void **>(chunk);
+				}
+				else
+					chunk = chunkAt(slab, slab->fresh++);
+
+				++slab->live;
+				if (!slab->free && slab->fresh == _chunksPerSlab)
+					unlinkAvailable(slab); //full
+				return chunk;
+			}
+
+			void free(void *chunk) noexcept
+			{
+				auto slab = SlabOf(chunk);
+				assert(slab->live > 0 && "chunk doesn't come from this storage or was freed already");
+				if (!slab->free && slab->fresh == _chunksPerSlab)
+					linkAvailable(slab); //was full
+
+				*static_cast<void **>(chunk) = slab->free;
+				slab->free = chunk;
+				--slab->live;
+				_live.store(_live.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+			}
+
+			//allocates slabs in advance so that there is room for 'count' chunks in total
+			//returns false if a slab couldn't be allocated
+			bool reserve(std::size_t count) noexcept
+			{
+				while (capacity() < count) {
+					if (!addSlab())
+						return false;
+				}
+				return true;
+			}
+
+			//releases the slabs which have no chunks in use
+			void shrink() noexcept
+			{
+				auto link = &_slabs;
+				while (*link) {
+					auto slab = *link;
+					if (slab->live == 0) {
+						*link = slab->nextSlab;
+						unlinkAvailable(slab);
+						releaseSlab(slab);
+					}
+					else
+						link = &slab->nextSlab;
+				}
+			}
+
+			//calls the function for each chunk in use
+			template <class Func>
+			void ForEachLive(Func &&f) const
+			{
+				std::vector<bool> isFree;
+				for (auto slab = _slabs; slab; slab = slab->nextSlab) {
+					if (slab->live == 0)
+						continue;
+
+					isFree.assign(slab->fresh, false);
+					for (auto chunk = slab->free; chunk; chunk = *static_cast<void **>(chunk))
+						isFree[indexOf(slab, chunk)] = true;
+
+					for (std::uint32_t i{0}; i < slab->fresh; ++i) {
+						if (!isFree[i])
+							f(chunkAt(slab, i));
+					}
+				}
+			}
+
+			//the layout depends only on the object size and alignment, so it can be computed at compile time for a type
+			//(free chunks hold the link of the free list, so they are aligned for a pointer too)
+			static constexpr std::size_t chunk_align_for(std::size_t alignment) noexcept
+			{
+				return std::max(alignment, alignof(void *));
+			}
+
+			static constexpr std::size_t chunk_size_for(std::size_t size, std::size_t alignment) noexcept
+			{
+				return roundUp(std::max(size, sizeof(void *)), chunk_align_for(alignment));
+			}
+
+			static constexpr std::size_t slab_size_for(std::size_t size, std::size_t alignment) noexcept
+			{
+				return std::max(page_size, std::bit_ceil(roundUp(sizeof(SlabHeader), chunk_align_for(alignment)) + min_chunks_per_slab * chunk_size_for(size, alignment)));
+			}
+
+			//finds the storage of a chunk given the slab size of the storage
+			static SlabStorage *OwnerOf(const void *chunk, std::size_t slabSize) noexcept
+			{
+				return reinterpret_cast<SlabHeader *>(reinterpret_cast<std::uintptr_t>(chunk) & ~(slabSize - 1))->owner;
+			}
+
+			std::size_t chunk_size() const noexcept { return _chunkSize; }
+			std::size_t slab_size() const noexcept { return _slabSize; }
+			std::size_t slab_count() const noexcept { return _slabCount.load(std::memory_order_relaxed); }
+			std::size_t capacity() const noexcept { return slab_count() * _chunksPerSlab; }
+
+			//can be called from any thread, but the numbers needn't be mutually consistent while the storage is in use
+			PoolStats stats() const noexcept
+			{
+				return {
+					_live.load(std::memory_order_relaxed),
+					_peak.load(std::memory_order_relaxed),
+					capacity(),
+					slab_count() * _slabSize
+				};
+			}
+
+			std::size_t limit() const noexcept { return _limit; }
+
+			//sets the maximum number of chunks in use at once; malloc fails while it is reached, also if it is lowered below the chunks in use
+			void set_limit(std::size_t maxLive) noexcept { _limit = maxLive; }
+
+			SlabHeader *SlabOf(const void *chunk) const noexcept
+			{
+				return reinterpret_cast<SlabHeader *>(reinterpret_cast<std::uintptr_t>(chunk) & ~(_slabSize - 1));
+			}
+
+		  private:
+
+			static constexpr std::size_t roundUp(std::size_t size, std::size_t align) noexcept
+			{
+				return (size + align - 1) & ~(align - 1);
+			}
+
+			void *chunkAt(SlabHeader *slab, std::uint32_t index) const noexcept
+			{
+				return reinterpret_cast<std::byte *>(slab) + _chunksOffset + index * _chunkSize;
+			}
+
+			std::uint32_t indexOf(SlabHeader *slab, const void *chunk) const noexcept
+			{
+				return static_cast<std::uint32_t>((static_cast<const std::byte *>(chunk) - reinterpret_cast<std::byte *>(slab) - _chunksOffset) / _chunkSize);
+			}
+
+			bool addSlab() noexcept
+			{
+				auto memory = ::operator new(_slabSize, std::align_val_t{_slabSize}, std::nothrow);
+				if (!memory)
+					return false;
+
+				auto slab = ::new (memory) SlabHeader{this, nullptr, nullptr, _slabs, nullptr, 0, 0};
+				_slabs = slab;
+				_slabCount.store(slab_count() + 1, std::memory_order_relaxed);
+				linkAvailable(slab);
+				return true;
+			}
+
+			void releaseSlab(SlabHeader *slab) noexcept
+			{
+				_slabCount.store(slab_count() - 1, std::memory_order_relaxed);
+				::operator delete(slab, std::align_val_t{_slabSize});
+			}
+
+			void linkAvailable(SlabHeader *slab) noexcept
+			{
+				slab->prev = nullptr;
+				slab->next = _available;
+				if (_available)
+					_available->prev = slab;
+				_available = slab;
+			}
+
+			void unlinkAvailable(SlabHeader *slab) noexcept
+			{
+				if (slab->prev)
+					slab->prev->next = slab->next;
+				else
+					_available = slab->next;
+
+				if (slab->next)
+					slab->next->prev = slab->prev;
+			}
+
+			std::size_t _chunkSize;
+			std::size_t _chunksOffset;
+			std::size_t _slabSize;
+			std::uint32_t _chunksPerSlab;
+
+			SlabHeader *_slabs{nullptr};		//all slabs
+			SlabHeader *_available{nullptr};	//slabs with available chunks
+			std::size_t _limit{unlimited};
+
+			//written only by the owner, but can be read by other threads for statistics
+			std::atomic<std::size_t> _slabCount{0};
+			std::atomic<std::size_t> _live{0};
+			std::atomic<std::size_t> _peak{0};
+		};
+
+	} //ns Private
+
+	//Pool of objects of type T with constant allocation and deallocation, a replacement of boost::object_pool.
+	//Like boost::object_pool it destroys objects still alive when the pool itself is destroyed.
+	template <class T>
+	class SlabPool : Private::SlabStorage {
+
+	  public:
+
+		SlabPool() noexcept
+			: SlabStorage{sizeof(T), alignof(T)} {}
+
+		~SlabPool()
+		{
+			if constexpr (!std::is_trivially_destructible_v<T>) {
+				ForEachLive([](void *chunk) {
+					static_cast<T *>(chunk)->~T();
+				});
+			}
+		}
+
+		//returns uninitialized memory for one T or nullptr on failure
+		T *malloc() noexcept
+		{
+			return static_cast<T *>(SlabStorage::malloc());
+		}
+
+		void free(T *ptr) noexcept
+		{
+			SlabStorage::free(ptr);
+		}
+
+		void destroy(T *obj) noexcept
+		{
+			obj->~T();
+			free(obj);
+		}
+
+		using SlabStorage::reserve;
+		using SlabStorage::shrink;
+		using SlabStorage::slab_size;
+		using SlabStorage::slab_count;
+		using SlabStorage::capacity;
+		using SlabStorage::stats;
+		using SlabStorage::limit;
+		using SlabStorage::set_limit;
+		using SlabStorage::unlimited;
+	};
+
+} //ns
+
+#endif //file guard
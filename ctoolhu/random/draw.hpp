@@ -0,0 +1,89 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_random_draw_included_
+#define _ctoolhu_random_draw_included_
+
+#include "engines.hpp"
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+//draws straight from an engine, without the setup of a distribution object
+namespace Ctoolhu::Random {
+
+	namespace Private {
+
+		template <class Engine>
+		constexpr std::uint64_t engine_range{static_cast<std::uint64_t>(Engine::max() - Engine::min())};
+
+		//engines producing full 32 or 64-bit words can be used without a distribution
+		template <class Engine>
+		constexpr bool has_full_words{engine_range<Engine> == std::numeric_limits<std::uint32_t>::max() || engine_range<Engine> == std::numeric_limits<std::uint64_t>::max()};
+
+		template <class Engine>
+		std::uint32_t Draw32(Engine &engine)
+		{
+			if constexpr (engine_range<Engine> == std::numeric_limits<std::uint32_t>::max())
+				return static_cast<std::uint32_t>(engine() - Engine::min());
+			else
+				return static_cast<std::uint32_t>((engine() - Engine::min()) >> 32);
+		}
+
+		template <class Engine>
+		std::uint64_t Draw64(Engine &engine)
+		{
+			if constexpr (engine_range<Engine> == std::numeric_limits<std::uint32_t>::max()) {
+				auto const high = Draw32(engine);
+				return (static_cast<std::uint64_t>(high) << 32) | Draw32(engine);
+			}
+			else
+				return static_cast<std::uint64_t>(engine() - Engine::min());
+		}
+
+	} //ns Private
+
+	//Uniformly distributed integer in [0, bound), by Lemire's nearly divisionless method -
+	//a single multiplication for most draws, a division only when the draw lands in the biased part.
+	template <class Engine>
+	std::uint64_t UniformBelow(Engine &engine, std::uint64_t bound)
+	{
+		assert(bound > 0 && "empty range");
+		if constexpr (!Private::has_full_words<Engine>)
+			return std::uniform_int_distribution<std::uint64_t>{0, bound - 1}(engine);
+		else if (bound <= std::numeric_limits<std::uint32_t>::max()) {
+			auto const bound32 = static_cast<std::uint32_t>(bound);
+			auto product = static_cast<std::uint64_t>(Private::Draw32(engine)) * bound32;
+			if (static_cast<std::uint32_t>(product) < bound32) {
+				auto const threshold = static_cast<std::uint32_t>(-bound32) % bound32;
+				while (static_cast<std::uint32_t>(product) < threshold)
+					product = static_cast<std::uint64_t>(Private::Draw32(engine)) * bound32;
+			}
+			return product >> 32;
+		}
+		else {
+			std::uint64_t high, low;
+			Private::Multiply(Private::Draw64(engine), bound, high, low);
+			if (low < bound) {
+				auto const threshold = (0 - bound) % bound;
+				while (low < threshold)
+					Private::Multiply(Private::Draw64(engine), bound, high, low);
+			}
+			return high;
+		}
+	}
+
+	//uniformly distributed number in [0, 1) with the 53 bits of precision of a double
+	template <class Engine>
+	double UniformUnit(Engine &engine)
+	{
+		if constexpr (!Private::has_full_words<Engine>)
+			return std::generate_canonical<double, std::numeric_limits<double>::digits>(engine);
+		else
+			return static_cast<double>(Private::Draw64(engine) >> 11) * 0x1.0p-53;
+	}
+
+} //ns Ctoolhu::Random
+
+#endif //file guard
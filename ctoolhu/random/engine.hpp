@@ -4,14 +4,116 @@
 #ifndef _ctoolhu_random_engine_included_
 #define _ctoolhu_random_engine_included_
 
-#include "../singleton/holder.hpp"
+#include "engines.hpp"
+#include <atomic>
+#include <cstdint>
 #include <random>
 
-namespace Ctoolhu::Random::Private {
+namespace Ctoolhu::Random {
 
-	using RandomEngine = std::mt19937; //random generator engine
-	using SingleRandomEngine = Singleton::Holder<RandomEngine>;
+	namespace Private {
 
-}
+		using RandomEngine = std::mt19937; //default random generator engine
+
+		//seed all the thread engines are derived from, along with the count of reseedings so that the engines notice
+		struct MasterSeed {
+			std::atomic<std::uint64_t> value{RandomEngine::default_seed};
+			std::atomic<std::uint32_t> epoch{0};
+		};
+
+		inline MasterSeed masterSeed;
+		inline std::atomic<std::uint64_t> nextStream{0};
+
+		//Stream id of a thread, shared by all its engines.
+		//Threads get stream ids in the order they first use their engines, unless assigned one explicitly.
+		struct ThreadStream {
+
+			static ThreadStream &Instance()
+			{
+				thread_local ThreadStream stream;
+				return stream;
+			}
+
+			std::uint64_t id{nextStream.fetch_add(1, std::memory_order_relaxed)};
+			std::uint32_t version{0};	//count of reassignments of the id
+		};
+
+		//Random engine of given type of a single thread, seeded from the master seed and the thread's stream id.
+		template <class Engine>
+		class ThreadEngine {
+
+		  public:
+
+			ThreadEngine(const ThreadEngine &) = delete;
+			ThreadEngine &operator=(const ThreadEngine &) = delete;
+
+			static ThreadEngine &Instance()
+			{
+				thread_local ThreadEngine engine;
+				return engine;
+			}
+
+			//the engine, reseeded first if the master seed or the stream has changed since it was last seeded
+			Engine &Get()
+			{
+				if (_epoch != masterSeed.epoch.load(std::memory_order_acquire) || _streamVersion != _stream.version)
+					reseed();
+
+				return _engine;
+			}
+
+		  private:
+
+			ThreadEngine()
+				: _stream{ThreadStream::Instance()}
+			{
+				reseed();
+			}
+
+			void reseed()
+			{
+				_epoch = masterSeed.epoch.load(std::memory_order_acquire);
+				_streamVersion = _stream.version;
+				auto const seed = masterSeed.value.load(std::memory_order_relaxed);
+				std::seed_seq seq{
+					static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32),
+					static_cast<std::uint32_t>(_stream.id), static_cast<std::uint32_t>(_stream.id >> 32)
+				};
+				_engine.seed(seq);
+			}
+
+			Engine _engine;
+			ThreadStream &_stream;
+			std::uint32_t _epoch;
+			std::uint32_t _streamVersion;
+		};
+
+		//engine of given type of the calling thread
+		template <class Engine = RandomEngine>
+		Engine &ThisThreadEngine()
+		{
+			return ThreadEngine<Engine>::Instance().Get();
+		}
+
+	} //ns Private
+
+	//Sets the master seed of all threads' engines.
+	//Other threads pick it up the next time they construct a generator.
+	inline void Seed(std::uint64_t masterSeed)
+	{
+		Private::masterSeed.value.store(masterSeed, std::memory_order_relaxed);
+		Private::masterSeed.epoch.fetch_add(1, std::memory_order_release);
+	}
+
+	//Assigns the calling thread the stream id its engines are seeded with along with the master seed.
+	//Parallel runs are reproducible if each worker sets its stream id (e.g. its index) before drawing.
+	inline void SetStream(std::uint64_t streamId)
+	{
+		auto &stream = Private::ThreadStream::Instance();
+		stream.id = streamId;
+		++stream.version;
+	}
+
+} //ns Ctoolhu::Random
 
 #endif //file guard
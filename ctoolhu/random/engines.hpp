@@ -0,0 +1,237 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_random_engines_included_
+#define _ctoolhu_random_engines_included_
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+//Random engines much faster to step and with much smaller state than std::mt19937.
+//They all satisfy UniformRandomBitGenerator and can be seeded by a number or a seed sequence,
+//so they can be used as the engine of Random generators, e.g.
+//
+//	Random::Generator<std::uniform_int_distribution<>, int, Random::Xoshiro256StarStar> gen(1, 6);
+//
+namespace Ctoolhu::Random {
+
+	namespace Private {
+
+#ifdef __SIZEOF_INT128__
+		__extension__ typedef unsigned __int128 uint128_t; //__extension__ keeps -Wpedantic quiet about the non-standard type
+#endif
+
+		//full 128-bit product of two 64-bit numbers
+		inline void Multiply(std::uint64_t a, std::uint64_t b, std::uint64_t &high, std::uint64_t &low) noexcept
+		{
+#ifdef __SIZEOF_INT128__
+			auto const product = static_cast<uint128_t>(a) * b;
+			high = static_cast<std::uint64_t>(product >> 64);
+			low = static_cast<std::uint64_t>(product);
+#else
+			auto const aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+			auto const bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+			auto const ll = aLow * bLow, lh = aLow * bHigh, hl = aHigh * bLow, hh = aHigh * bHigh;
+			auto const middle = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+			high = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+			low = (middle << 32) | (ll & 0xFFFFFFFF);
+#endif
+		}
+
+		template <class T>
+		concept SeedSequence = requires(T &seq, std::uint32_t *out) { seq.generate(out, out); };
+
+		//draws 64-bit words from a seed sequence (e.g. std::seed_seq)
+		template <std::size_t Count, SeedSequence SeedSeq>
+		std::array<std::uint64_t, Count> GenerateWords(SeedSeq &seq)
+		{
+			std::array<std::uint32_t, Count * 2> halves;
+			seq.generate(halves.begin(), halves.end());
+			std::array<std::uint64_t, Count> words;
+			for (std::size_t i{0}; i < Count; ++i)
+				words[i] = (static_cast<std::uint64_t>(halves[2 * i + 1]) << 32) | halves[2 * i];
+
+			return words;
+		}
+
+	} //ns Private
+
+	//Tiny engine with 64 bits of state, mainly for expanding a single seed into the state of bigger engines.
+	class SplitMix64 {
+
+	  public:
+
+		using result_type = std::uint64_t;
+
+		static constexpr result_type min() noexcept { return 0; }
+		static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+		explicit SplitMix64(std::uint64_t seed = 0) noexcept
+			: _state{seed} {}
+
+		void seed(std::uint64_t seed) noexcept
+		{
+			_state = seed;
+		}
+
+		template <Private::SeedSequence SeedSeq>
+		void seed(SeedSeq &seq)
+		{
+			_state = Private::GenerateWords<1>(seq)[0];
+		}
+
+		result_type operator()() noexcept
+		{
+			auto z = (_state += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+	  private:
+
+		std::uint64_t _state;
+	};
+
+	//Xoshiro256** by Blackman and Vigna - fast all-purpose engine with 256 bits of state.
+	class Xoshiro256StarStar {
+
+	  public:
+
+		using result_type = std::uint64_t;
+
+		static constexpr result_type min() noexcept { return 0; }
+		static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+		explicit Xoshiro256StarStar(std::uint64_t seed = 0) noexcept
+		{
+			this->seed(seed);
+		}
+
+		void seed(std::uint64_t seed) noexcept
+		{
+			SplitMix64 expander{seed};
+			for (auto &word : _state)
+				word = expander();
+		}
+
+		template <Private::SeedSequence SeedSeq>
+		void seed(SeedSeq &seq)
+		{
+			_state = Private::GenerateWords<4>(seq);
+			if (_state == decltype(_state){})
+				_state[0] = 1; //all-zero state would only ever produce zeros
+		}
+
+		result_type operator()() noexcept
+		{
+			auto const result = std::rotl(_state[1] * 5, 7) * 9;
+			auto const t = _state[1] << 17;
+			_state[2] ^= _state[0];
+			_state[3] ^= _state[1];
+			_state[1] ^= _state[2];
+			_state[0] ^= _state[3];
+			_state[2] ^= t;
+			_state[3] = std::rotl(_state[3], 45);
+			return result;
+		}
+
+		//advances the engine by 2^128 draws, giving a sequence not overlapping with the skipped one
+		void jump() noexcept
+		{
+			constexpr std::uint64_t polynomial[] = {0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+			decltype(_state) jumped{};
+			for (auto word : polynomial) {
+				for (int bit{0}; bit < 64; ++bit) {
+					if (word & (std::uint64_t{1} << bit)) {
+						for (std::size_t i{0}; i < jumped.size(); ++i)
+							jumped[i] ^= _state[i];
+					}
+					(*this)();
+				}
+			}
+			_state = jumped;
+		}
+
+	  private:
+
+		std::array<std::uint64_t, 4> _state;
+	};
+
+	//PCG64 (XSL RR 128/64) by O'Neill - 128-bit linear congruential engine with a permuted output.
+	//Engines seeded with different streams produce independent sequences.
+	class Pcg64 {
+
+	  public:
+
+		using result_type = std::uint64_t;
+
+		static constexpr result_type min() noexcept { return 0; }
+		static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+		explicit Pcg64(std::uint64_t seed = 0, std::uint64_t stream = 0) noexcept
+		{
+			this->seed(seed, stream);
+		}
+
+		void seed(std::uint64_t seed, std::uint64_t stream = 0) noexcept
+		{
+			SplitMix64 expander{seed};
+			auto const stateHigh = expander(), stateLow = expander();
+			reset({stateHigh, stateLow}, {stream >> 63, (stream << 1) | 1});
+		}
+
+		template <Private::SeedSequence SeedSeq>
+		void seed(SeedSeq &seq)
+		{
+			auto const words = Private::GenerateWords<4>(seq);
+			reset({words[0], words[1]}, {words[2] >> 1, (words[2] << 63) | (words[3] >> 1) | 1});
+		}
+
+		result_type operator()() noexcept
+		{
+			step();
+			return std::rotr(_state.high ^ _state.low, static_cast<int>(_state.high >> 58));
+		}
+
+	  private:
+
+		struct UInt128 {
+			std::uint64_t high;
+			std::uint64_t low;
+		};
+
+		static constexpr UInt128 multiplier{2549297995355413924ull, 4865540595714422341ull};
+
+		void reset(UInt128 state, UInt128 increment) noexcept
+		{
+			_increment = increment;
+			_state = {0, 0};
+			step();
+			_state.low += state.low;
+			_state.high += state.high + (_state.low < state.low);
+			step();
+		}
+
+		//state = state * multiplier + increment (mod 2^128)
+		void step() noexcept
+		{
+			std::uint64_t high, low;
+			Private::Multiply(_state.low, multiplier.low, high, low);
+			high += _state.low * multiplier.high + _state.high * multiplier.low;
+			low += _increment.low;
+			high += _increment.high + (low < _increment.low);
+			_state = {high, low};
+		}
+
+		UInt128 _state;
+		UInt128 _increment; //odd, selects the stream
+	};
+
+} //ns Ctoolhu::Random
+
+#endif //file guard
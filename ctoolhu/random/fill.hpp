@@ -0,0 +1,214 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_random_fill_included_
+#define _ctoolhu_random_fill_included_
+
+#include "draw.hpp"
+#include "engine.hpp"
+#include "engines.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+namespace Ctoolhu::Random {
+
+	namespace Private {
+
+		//Xoshiro256** engines interleaved lane by lane, so that stepping all of them at once vectorizes.
+		//Also usable as a plain engine, which steps the first lane only.
+		template <std::size_t Lanes = 8>
+		class XoshiroLanes {
+
+		  public:
+
+			using result_type = std::uint64_t;
+			static constexpr std::size_t lanes{Lanes};
+
+			static constexpr result_type min() noexcept { return 0; }
+			static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+			explicit XoshiroLanes(std::uint64_t seed = 0) noexcept
+			{
+				this->seed(seed);
+			}
+
+			void seed(std::uint64_t seed) noexcept
+			{
+				SplitMix64 expander{seed};
+				for (auto &word : _state)
+					word = expander();
+			}
+
+			template <SeedSequence SeedSeq>
+			void seed(SeedSeq &seq)
+			{
+				_state = GenerateWords<4 * Lanes>(seq);
+				for (std::size_t lane{0}; lane < Lanes; ++lane) {
+					if ((state(0, lane) | state(1, lane) | state(2, lane) | state(3, lane)) == 0)
+						state(0, lane) = 1; //all-zero lane would only ever produce zeros
+				}
+			}
+
+			result_type operator()() noexcept
+			{
+				auto const result = std::rotl(state(1, 0) * 5, 7) * 9;
+				auto const t = state(1, 0) << 17;
+				state(2, 0) ^= state(0, 0);
+				state(3, 0) ^= state(1, 0);
+				state(1, 0) ^= state(2, 0);
+				state(0, 0) ^= state(3, 0);
+				state(2, 0) ^= t;
+				state(3, 0) = std::rotl(state(3, 0), 45);
+				return result;
+			}
+
+			//writes given number of draws, rounded up to a multiple of the lane count
+			void Fill(std::uint64_t *out, std::size_t count) noexcept
+			{
+				//works on a local copy of the state, so that the compiler knows the output doesn't alias it
+				std::uint64_t s0[Lanes], s1[Lanes], s2[Lanes], s3[Lanes];
+				std::copy_n(&_state[0], Lanes, s0);
+				std::copy_n(&_state[Lanes], Lanes, s1);
+				std::copy_n(&_state[2 * Lanes], Lanes, s2);
+				std::copy_n(&_state[3 * Lanes], Lanes, s3);
+				for (std::size_t n{0}; n < count; n += Lanes) {
+					for (std::size_t i{0}; i < Lanes; ++i) {
+						auto const x = (s1[i] << 2) + s1[i];	//* 5
+						auto const r = (x << 7) | (x >> 57);
+						out[n + i] = (r << 3) + r;				//* 9
+						auto const t = s1[i] << 17;
+						s2[i] ^= s0[i];
+						s3[i] ^= s1[i];
+						s1[i] ^= s2[i];
+						s0[i] ^= s3[i];
+						s2[i] ^= t;
+						s3[i] = (s3[i] << 45) | (s3[i] >> 19);
+					}
+				}
+				std::copy_n(s0, Lanes, &_state[0]);
+				std::copy_n(s1, Lanes, &_state[Lanes]);
+				std::copy_n(s2, Lanes, &_state[2 * Lanes]);
+				std::copy_n(s3, Lanes, &_state[3 * Lanes]);
+			}
+
+		  private:
+
+			std::uint64_t &state(std::size_t word, std::size_t lane) noexcept { return _state[word * Lanes + lane]; }
+
+			std::array<std::uint64_t, 4 * Lanes> _state; //the lanes of each word of state are adjacent
+		};
+
+		using BatchEngine = XoshiroLanes<>;
+		constexpr std::size_t batch_size{256};
+
+		template <class Engine> constexpr bool is_lanes_v = false;
+		template <std::size_t Lanes> constexpr bool is_lanes_v<XoshiroLanes<Lanes>> = true;
+
+		//generates random words in batches and hands them to the consumer along with the position in the output
+		//(all lanes at once for the interleaved engines, a draw at a time for the others)
+		template <class Engine, class Consumer>
+		void GenerateBatches(Engine &engine, std::size_t count, Consumer consume)
+		{
+			alignas(64) std::uint64_t words[batch_size];
+			for (std::size_t done{0}; done < count;) {
+				auto const n = std::min(batch_size, count - done);
+				if constexpr (is_lanes_v<Engine>)
+					engine.Fill(words, n);
+				else
+					std::generate_n(words, n, [&engine] { return Draw64(engine); });
+
+				consume(words, done, n);
+				done += n;
+			}
+		}
+
+	} //ns Private
+
+	//Fills the buffer with uniformly distributed integers in [lower, upper] drawn from given engine.
+	//The random words are mapped to the range by Lemire's multiply-shift with rare rejections to stay unbiased.
+	template <class Engine, std::integral T> requires (!std::same_as<T, bool>) && Private::has_full_words<Engine>
+	void fill_uniform(Engine &engine, std::span<T> out, T lower, T upper)
+	{
+		assert(lower <= upper && "invalid range");
+		using unsigned_t = std::make_unsigned_t<T>;
+		auto const span = static_cast<std::uint64_t>(static_cast<unsigned_t>(static_cast<unsigned_t>(upper) - static_cast<unsigned_t>(lower)));
+		auto const offset = [lower](std::uint64_t x) { return static_cast<T>(static_cast<unsigned_t>(lower) + static_cast<unsigned_t>(x)); };
+
+		if (span < std::numeric_limits<std::uint32_t>::max()) {
+			auto const bound = static_cast<std::uint32_t>(span + 1);
+			auto const threshold = static_cast<std::uint32_t>(-bound) % bound; //products with lower 32 bits below this are biased
+			Private::GenerateBatches(engine, out.size(), [&](const std::uint64_t *words, std::size_t position, std::size_t count) {
+				auto dest = out.data() + position;
+				for (std::size_t i{0}; i < count; ++i)
+					dest[i] = offset(((words[i] >> 32) * bound) >> 32);
+
+				for (std::size_t i{0}; i < count; ++i) {
+					auto product = (words[i] >> 32) * bound;
+					if (static_cast<std::uint32_t>(product) >= threshold)
+						continue;
+
+					while (static_cast<std::uint32_t>(product) < threshold)
+						product = static_cast<std::uint64_t>(Private::Draw32(engine)) * bound;
+
+					dest[i] = offset(product >> 32);
+				}
+			});
+		}
+		else if (span == std::numeric_limits<std::uint64_t>::max()) {
+			Private::GenerateBatches(engine, out.size(), [&](const std::uint64_t *words, std::size_t position, std::size_t count) {
+				for (std::size_t i{0}; i < count; ++i)
+					out[position + i] = offset(words[i]);
+			});
+		}
+		else {
+			auto const bound = span + 1;
+			auto const threshold = (0 - bound) % bound;
+			Private::GenerateBatches(engine, out.size(), [&](const std::uint64_t *words, std::size_t position, std::size_t count) {
+				for (std::size_t i{0}; i < count; ++i) {
+					std::uint64_t high, low;
+					Private::Multiply(words[i], bound, high, low);
+					while (low < threshold)
+						Private::Multiply(Private::Draw64(engine), bound, high, low);
+
+					out[position + i] = offset(high);
+				}
+			});
+		}
+	}
+
+	//fills the buffer with uniformly distributed floating point numbers in [lower, upper) drawn from given engine
+	template <class Engine, std::floating_point T> requires Private::has_full_words<Engine>
+	void fill_uniform(Engine &engine, std::span<T> out, T lower, T upper)
+	{
+		assert(lower < upper && "invalid range");
+		constexpr int digits{std::numeric_limits<T>::digits < 64 ? std::numeric_limits<T>::digits : 64};
+		constexpr T scale{T{1} / static_cast<T>(std::uint64_t{1} << (digits - 1)) / 2};
+		auto const width = upper - lower;
+		auto const last = std::nextafter(upper, lower); //the sum can round up to the upper bound, which is excluded
+		Private::GenerateBatches(engine, out.size(), [&](const std::uint64_t *words, std::size_t position, std::size_t count) {
+			auto dest = out.data() + position;
+			for (std::size_t i{0}; i < count; ++i)
+				dest[i] = std::min(lower + static_cast<T>(words[i] >> (64 - digits)) * scale * width, last);
+		});
+	}
+
+	//Fills the buffer with uniformly distributed integers in [lower, upper] or floating point numbers in [lower, upper).
+	//The random words are generated in batches by interleaved xoshiro lanes of the calling thread.
+	template <class T> requires (std::integral<T> && !std::same_as<T, bool>) || std::floating_point<T>
+	void fill_uniform(std::span<T> out, T lower, T upper)
+	{
+		fill_uniform(Private::ThisThreadEngine<Private::BatchEngine>(), out, lower, upper);
+	}
+
+} //ns Ctoolhu::Random
+
+#endif //file guard
@@ -5,8 +5,14 @@
 #define _ctoolhu_random_generator_included_
 
 #include "engine.hpp"
+#include "fill.hpp"
 #include <boost/random/variate_generator.hpp>
 #include <boost/random/uniform_smallint.hpp>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <span>
+#include <utility>
 
 #ifdef _DEBUG_RAND
 #include <ctoolhu/event/events.h>
@@ -16,28 +22,70 @@
 
 namespace Ctoolhu::Random {
 
+	namespace Private {
+
+		//distributions whose values fill_uniform can generate in bulk
+		template <class Distribution> constexpr bool is_uniform_int_v = false;
+		template <class T> constexpr bool is_uniform_int_v<std::uniform_int_distribution<T>> = true;
+		template <class T> constexpr bool is_uniform_int_v<boost::uniform_smallint<T>> = true;
+
+		template <class Distribution> constexpr bool is_uniform_real_v = false;
+		template <class T> constexpr bool is_uniform_real_v<std::uniform_real_distribution<T>> = true;
+
+	} //ns Private
+
 	//shortcut for the generator template we'll be using
-	template <class Distribution>
-	using RandomGenerator = boost::variate_generator<Private::RandomEngine &, Distribution>;
+	template <class Distribution, class Engine = Private::RandomEngine>
+	using RandomGenerator = boost::variate_generator<Engine &, Distribution>;
 
-	//generator with run-time bounds
+	//Generator with run-time bounds.
+	//It draws from the engine of the thread that constructed it, so it shouldn't be shared between threads.
 	template <
 		class Distribution,
-		typename Boundary = int
+		typename Boundary = int,
+		class Engine = Private::RandomEngine	//any UniformRandomBitGenerator seedable by a seed sequence, e.g. Xoshiro256StarStar
 	>
-	class Generator : public RandomGenerator<Distribution> {
+	class Generator : public RandomGenerator<Distribution, Engine> {
 	
-		using base_t = RandomGenerator<Distribution>;
+		using base_t = RandomGenerator<Distribution, Engine>;
 
 	  public:
 
 		//for number generators
 		Generator(Boundary lower, Boundary upper)
-			: base_t(Private::SingleRandomEngine::Instance(), Distribution(lower, upper)) {}
+			: base_t(Private::ThisThreadEngine<Engine>(), Distribution(lower, upper)), _threadEngine{true} {}
 
 		//for bool generator
 		Generator()
-			: base_t(Private::SingleRandomEngine::Instance(), Distribution()) {}
+			: base_t(Private::ThisThreadEngine<Engine>(), Distribution()), _threadEngine{true} {}
+
+		//for number generators drawing from given engine rather than the thread's one (e.g. a task's StreamEngine)
+		Generator(Engine &engine, Boundary lower, Boundary upper)
+			: base_t(engine, Distribution(lower, upper)) {}
+
+		//for bool generator drawing from given engine
+		explicit Generator(Engine &engine)
+			: base_t(engine, Distribution()) {}
+
+		//Fills the buffer with values of the distribution.
+		//Uniform distributions are generated in bulk by fill_uniform, others a value at a time.
+		//A generator over the thread's engine fills from the thread's batch engine,
+		//one over given engine draws from that engine, so that the values are replayed from the same engine state.
+		void fill(std::span<typename base_t::result_type> out)
+		{
+			auto const &dist = this->distribution();
+			if constexpr (Private::is_uniform_int_v<Distribution> || Private::is_uniform_real_v<Distribution>) {
+				auto const [lower, upper] = bounds(dist);
+				if (_threadEngine)
+					fill_uniform(out, lower, upper);
+				else if constexpr (Private::has_full_words<Engine>)
+					fill_uniform(this->engine(), out, lower, upper);
+				else
+					std::generate(out.begin(), out.end(), std::ref(*this));
+			}
+			else
+				std::generate(out.begin(), out.end(), std::ref(*this));
+		}
 
 #ifdef _DEBUG_RAND
 		auto operator()()
@@ -47,20 +95,36 @@ namespace Ctoolhu::Random {
 			return res;
 		}
 #endif
+
+	  private:
+
+		static auto bounds(const Distribution &dist)
+		{
+			if constexpr (Private::is_uniform_int_v<Distribution>)
+				return std::pair{dist.min(), dist.max()};
+			else
+				return std::pair{dist.a(), dist.b()};
+		}
+
+		bool _threadEngine{false}; //drawing from the engine of the thread rather than a given one
 	};
 
 	//generator with compile-time bounds
 	template <
 		int LowerBound,
 		int UpperBound,
-		class Distribution = std::uniform_int_distribution<>
+		class Distribution = std::uniform_int_distribution<>,
+		class Engine = Private::RandomEngine
 	>
-	class StaticGenerator : public RandomGenerator<Distribution> {
+	class StaticGenerator : public RandomGenerator<Distribution, Engine> {
 
 	  public:
 
 		StaticGenerator()
-			: RandomGenerator<Distribution>(Private::SingleRandomEngine::Instance(), Distribution(LowerBound, UpperBound)) {}
+			: RandomGenerator<Distribution, Engine>(Private::ThisThreadEngine<Engine>(), Distribution(LowerBound, UpperBound)) {}
+
+		explicit StaticGenerator(Engine &engine)
+			: RandomGenerator<Distribution, Engine>(engine, Distribution(LowerBound, UpperBound)) {}
 	};
 
 	//expose typical usages of the dynamic generator
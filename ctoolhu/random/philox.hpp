@@ -0,0 +1,119 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_random_philox_included_
+#define _ctoolhu_random_philox_included_
+
+#include "engine.hpp"
+#include "engines.hpp"
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace Ctoolhu::Random {
+
+	//Counter-based engine Philox4x32-10 by Salmon et al.
+	//Its output is a pure function of the key and of a 128-bit counter made of the stream id and the position in the stream,
+	//so a stream can be derived from e.g. a task index, with no state shared with other streams, and replayed exactly.
+	class Philox4x32 {
+
+	  public:
+
+		using result_type = std::uint32_t;
+		using block_t = std::array<std::uint32_t, 4>;
+
+		static constexpr result_type min() noexcept { return 0; }
+		static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+		explicit Philox4x32(std::uint64_t key = 0, std::uint64_t stream = 0) noexcept
+		{
+			seed(key, stream);
+		}
+
+		void seed(std::uint64_t key, std::uint64_t stream = 0) noexcept
+		{
+			_key = key;
+			_stream = stream;
+			_position = 0;
+			_used = 4;
+		}
+
+		template <Private::SeedSequence SeedSeq>
+		void seed(SeedSeq &seq)
+		{
+			auto const words = Private::GenerateWords<2>(seq);
+			seed(words[0], words[1]);
+		}
+
+		result_type operator()() noexcept
+		{
+			if (_used == 4) {
+				_block = Block(_key, _stream, _position++);
+				_used = 0;
+			}
+			return _block[_used++];
+		}
+
+		//skips given number of draws in constant time
+		void discard(std::uint64_t count) noexcept
+		{
+			auto const buffered = static_cast<std::uint64_t>(4 - _used);
+			if (count <= buffered) {
+				_used += static_cast<unsigned>(count);
+				return;
+			}
+			count -= buffered;
+			_position += count / 4;
+			_used = 4;
+			if (auto const rest = static_cast<unsigned>(count % 4)) {
+				_block = Block(_key, _stream, _position++);
+				_used = rest;
+			}
+		}
+
+		//the four words of the stream of given key at given block position
+		static block_t Block(std::uint64_t key, std::uint64_t stream, std::uint64_t position) noexcept
+		{
+			block_t counter{
+				static_cast<std::uint32_t>(position), static_cast<std::uint32_t>(position >> 32),
+				static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)
+			};
+			std::uint32_t k0 = static_cast<std::uint32_t>(key), k1 = static_cast<std::uint32_t>(key >> 32);
+			for (int round{0}; round < 10; ++round) {
+				if (round > 0) {
+					k0 += 0x9E3779B9;
+					k1 += 0xBB67AE85;
+				}
+				auto const product0 = static_cast<std::uint64_t>(0xD2511F53) * counter[0];
+				auto const product1 = static_cast<std::uint64_t>(0xCD9E8D57) * counter[2];
+				counter = {
+					static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ k0, static_cast<std::uint32_t>(product1),
+					static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ k1, static_cast<std::uint32_t>(product0)
+				};
+			}
+			return counter;
+		}
+
+		friend bool operator==(const Philox4x32 &a, const Philox4x32 &b) noexcept
+		{
+			return a._key == b._key && a._stream == b._stream && a._position * 4 - (4 - a._used) == b._position * 4 - (4 - b._used);
+		}
+
+	  private:
+
+		std::uint64_t _key;
+		std::uint64_t _stream;
+		std::uint64_t _position;	//of the next block
+		block_t _block;
+		unsigned _used;				//words of the current block already drawn
+	};
+
+	//engine of an independent, reproducible stream for e.g. a task of a parallel run, keyed by the master seed
+	inline Philox4x32 StreamEngine(std::uint64_t streamId)
+	{
+		return Philox4x32{Private::masterSeed.value.load(std::memory_order_relaxed), streamId};
+	}
+
+} //ns Ctoolhu::Random
+
+#endif //file guard
@@ -4,41 +4,152 @@
 #ifndef _ctoolhu_random_selector_included_
 #define _ctoolhu_random_selector_included_
 
+#include "draw.hpp"
 #include "generator.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <iterator>
+#include <ranges>
+#include <unordered_set>
+#include <vector>
 
 namespace Ctoolhu::Random {
 
-	class Selector {
+	//Selects random members of containers, drawing straight from the engine of the thread that constructed it.
+	//Selection from random access ranges is constant, other ranges are walked.
+	template <class Engine = Private::RandomEngine>
+	class BasicSelector {
 
 	  public:
 
+		BasicSelector()
+			: _engine{&Private::ThisThreadEngine<Engine>()} {}
+
+		//selector drawing from given engine rather than the thread's one
+		explicit BasicSelector(Engine &engine)
+			: _engine{&engine} {}
+
 		//returns a reference to a random member in the container
 		template <typename Container>
 		decltype(auto) operator()(const Container &c)
 		{
-			assert(!c.empty() && "Can't select a random element from an empty container");
-			return *Select(std::cbegin(c), std::cend(c));
+			assert(!std::empty(c) && "Can't select a random element from an empty container");
+			if constexpr (std::ranges::sized_range<const Container>) {
+				auto it = std::cbegin(c);
+				std::advance(it, UniformBelow(*_engine, std::ranges::size(c)));
+				return *it;
+			}
+			else
+				return *Select(std::cbegin(c), std::cend(c));
 		}
 
-		//returns an iterator to a random member in the container
+		//returns an iterator to a random member in the range
 		template <typename Iterator>
 		Iterator Select(Iterator begin, Iterator end)
 		{
-			IntGenerator gen(0, std::distance(begin, end) - 1);
-			std::advance(begin, gen());
+			auto const count = static_cast<std::uint64_t>(std::distance(begin, end));
+			std::advance(begin, UniformBelow(*_engine, count));
 			return begin;
 		}
+
+		//Writes iterators to k distinct random members of the range, or to all of them if there are fewer than k.
+		//Random access ranges take O(k) draws (Floyd's algorithm), other ranges are walked once (reservoir sampling).
+		template <std::forward_iterator Iterator, std::output_iterator<Iterator> OutputIterator>
+		OutputIterator SelectK(Iterator begin, Iterator end, std::size_t k, OutputIterator out)
+		{
+			if constexpr (std::random_access_iterator<Iterator>) {
+				auto const n = static_cast<std::size_t>(end - begin);
+				if (k >= n)
+					return copyIterators(begin, end, out);
+
+				for (auto index : floydSample(n, k))
+					*out++ = begin + index;
+
+				return out;
+			}
+			else {
+				std::vector<Iterator> reservoir;
+				reservoir.reserve(k);
+				std::size_t seen{0};
+				for (auto it = begin; it != end; ++it, ++seen) {
+					if (seen < k)
+						reservoir.push_back(it);
+					else if (auto const j = UniformBelow(*_engine, seen + 1); j < k)
+						reservoir[j] = it;
+				}
+				return std::copy(reservoir.begin(), reservoir.end(), out);
+			}
+		}
+
+		//returns iterators to k distinct random members of the container
+		template <typename Container>
+		auto SelectK(const Container &c, std::size_t k)
+		{
+			std::vector<decltype(std::cbegin(c))> selected;
+			selected.reserve(k);
+			SelectK(std::cbegin(c), std::cend(c), k, std::back_inserter(selected));
+			return selected;
+		}
+
+	  private:
+
+		template <class Iterator, class OutputIterator>
+		static OutputIterator copyIterators(Iterator begin, Iterator end, OutputIterator out)
+		{
+			for (; begin != end; ++begin)
+				*out++ = begin;
+
+			return out;
+		}
+
+		//k distinct indices lower than n, each drawn once
+		std::vector<std::size_t> floydSample(std::size_t n, std::size_t k)
+		{
+			std::vector<std::size_t> chosen;
+			chosen.reserve(k);
+			constexpr std::size_t linear_search_limit{32};
+			if (k <= linear_search_limit) {
+				for (auto j = n - k; j < n; ++j) {
+					auto const t = static_cast<std::size_t>(UniformBelow(*_engine, j + 1));
+					chosen.push_back(std::find(chosen.begin(), chosen.end(), t) == chosen.end() ? t : j);
+				}
+			}
+			else {
+				std::unordered_set<std::size_t> seen;
+				seen.reserve(k);
+				for (auto j = n - k; j < n; ++j) {
+					auto const t = static_cast<std::size_t>(UniformBelow(*_engine, j + 1));
+					auto const index = seen.insert(t).second ? t : j;
+					if (index == j)
+						seen.insert(j);
+
+					chosen.push_back(index);
+				}
+			}
+			return chosen;
+		}
+
+		Engine *_engine; //a pointer rather than a reference keeps the selector assignable
 	};
 
-	template <typename Container>
+	//selector drawing from the default engine
+	using Selector = BasicSelector<>;
+
+	template <class Engine = Private::RandomEngine, typename Container>
 	decltype(auto) Select(const Container &c)
 	{
-		Selector s;
+		BasicSelector<Engine> s;
 		return s(c);
 	}
 
+	template <class Engine = Private::RandomEngine, typename Container>
+	auto SelectK(const Container &c, std::size_t k)
+	{
+		BasicSelector<Engine> s;
+		return s.SelectK(c, k);
+	}
+
 } //ns Ctoolhu::Random
 
 #endif //file guard
@@ -0,0 +1,202 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_random_weighted_selector_included_
+#define _ctoolhu_random_weighted_selector_included_
+
+#include "draw.hpp"
+#include "engine.hpp"
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+namespace Ctoolhu::Random {
+
+	namespace Private {
+
+		//selection of container members by the index drawn by the derived selector, the same way as by Selector
+		template <class Derived>
+		class IndexSelection {
+
+		  public:
+
+			//returns a reference to the member of the container at the drawn index (the container holds a member per weight)
+			template <typename Container>
+			decltype(auto) operator()(const Container &c)
+			{
+				assert(std::ranges::size(c) == derived().size() && "container doesn't match the weights");
+				return *std::next(std::cbegin(c), derived()());
+			}
+
+			//returns an iterator to the member of the range at the drawn index
+			template <typename Iterator>
+			Iterator Select(Iterator begin, [[maybe_unused]] Iterator end)
+			{
+				assert(static_cast<std::size_t>(std::distance(begin, end)) == derived().size() && "range doesn't match the weights");
+				return std::next(begin, derived()());
+			}
+
+		  private:
+
+			Derived &derived() noexcept { return static_cast<Derived &>(*this); }
+		};
+
+	} //ns Private
+
+	//Draws indices with probabilities proportional to fixed weights, in constant time by Vose's alias method.
+	//Building the alias table is linear, so for weights changing between draws use DynamicWeightedSelector, e.g.
+	//
+	//	WeightedSelector moveType{std::vector{5.0, 1.0, 2.0}};
+	//	auto &move = moveType(moves); //member of moves with index 0 picked 5 times more often than with index 1
+	//
+	template <class Engine = Private::RandomEngine>
+	class WeightedSelector : public Private::IndexSelection<WeightedSelector<Engine>> {
+
+	  public:
+
+		using Private::IndexSelection<WeightedSelector>::operator();
+
+		template <std::ranges::input_range Weights>
+		explicit WeightedSelector(const Weights &weights)
+			: _engine{&Private::ThisThreadEngine<Engine>()}
+		{
+			assign(weights);
+		}
+
+		//rebuilds the alias table for new weights (non-negative, not all zero)
+		template <std::ranges::input_range Weights>
+		void assign(const Weights &weights)
+		{
+			std::vector<double> scaled(std::ranges::begin(weights), std::ranges::end(weights));
+			auto const n = scaled.size();
+			auto const total = std::accumulate(scaled.begin(), scaled.end(), 0.0);
+			assert(n > 0 && total > 0 && "weights must not be all zero");
+
+			_probability.assign(n, 1.0);
+			_alias.resize(n);
+			std::iota(_alias.begin(), _alias.end(), std::size_t{0});
+
+			std::vector<std::size_t> small, large;
+			for (std::size_t i{0}; i < n; ++i) {
+				assert(scaled[i] >= 0 && "negative weight");
+				scaled[i] *= n / total;
+				(scaled[i] < 1.0 ? small : large).push_back(i);
+			}
+			while (!small.empty() && !large.empty()) {
+				auto const less = small.back(), more = large.back();
+				small.pop_back();
+				_probability[less] = scaled[less];
+				_alias[less] = more;
+				scaled[more] -= 1.0 - scaled[less];
+				if (scaled[more] < 1.0) {
+					large.pop_back();
+					small.push_back(more);
+				}
+			}
+			//whatever is left has probability 1 up to rounding errors, which is the initial value
+		}
+
+		//returns an index drawn with probability proportional to its weight
+		std::size_t operator()()
+		{
+			auto const i = static_cast<std::size_t>(UniformBelow(*_engine, _alias.size()));
+			return UniformUnit(*_engine) < _probability[i] ? i : _alias[i];
+		}
+
+		std::size_t size() const noexcept { return _alias.size(); }
+
+	  private:
+
+		Engine *_engine; //not a reference, so that the selector is assignable
+		std::vector<double> _probability;	//of keeping the drawn column rather than taking its alias
+		std::vector<std::size_t> _alias;
+	};
+
+	//Draws indices with probabilities proportional to weights which can change between draws.
+	//The weights are kept in a Fenwick tree, so both updating a weight and drawing are logarithmic.
+	template <class Engine = Private::RandomEngine>
+	class DynamicWeightedSelector : public Private::IndexSelection<DynamicWeightedSelector<Engine>> {
+
+	  public:
+
+		using Private::IndexSelection<DynamicWeightedSelector>::operator();
+
+		DynamicWeightedSelector()
+			: _engine{&Private::ThisThreadEngine<Engine>()}
+			, _tree(1, 0.0) {}
+
+		template <std::ranges::input_range Weights>
+		explicit DynamicWeightedSelector(const Weights &weights)
+			: DynamicWeightedSelector()
+		{
+			for (auto weight : weights)
+				push_back(weight);
+		}
+
+		//adds an index with given weight
+		void push_back(double weight)
+		{
+			assert(weight >= 0 && "negative weight");
+			auto const node = _weights.size() + 1;
+			_weights.push_back(weight);
+			//the new node sums the weights of the range it covers, which are the trailing weights already in the tree
+			_tree.push_back(weight + prefixSum(node - 1) - prefixSum(node - (node & (0 - node))));
+		}
+
+		void SetWeight(std::size_t index, double weight)
+		{
+			assert(weight >= 0 && "negative weight");
+			auto const delta = weight - _weights[index];
+			_weights[index] = weight;
+			for (auto node = index + 1; node < _tree.size(); node += node & (0 - node))
+				_tree[node] += delta;
+		}
+
+		double Weight(std::size_t index) const noexcept { return _weights[index]; }
+		double Total() const noexcept { return prefixSum(_weights.size()); }
+
+		//returns an index drawn with probability proportional to its weight
+		std::size_t operator()()
+		{
+			assert(Total() > 0 && "weights must not be all zero");
+			while (true) {
+				auto target = UniformUnit(*_engine) * Total();
+				//descends the tree to the first index whose prefix sum exceeds the target
+				std::size_t position{0};
+				for (auto step = std::bit_floor(_weights.size()); step; step /= 2) {
+					if (position + step < _tree.size() && _tree[position + step] <= target) {
+						position += step;
+						target -= _tree[position];
+					}
+				}
+				if (position < _weights.size()) //beyond the end only by rounding errors of the sums
+					return position;
+			}
+		}
+
+		std::size_t size() const noexcept { return _weights.size(); }
+
+	  private:
+
+		//sum of the weights of indices lower than given count
+		double prefixSum(std::size_t count) const noexcept
+		{
+			double sum{0};
+			for (; count; count -= count & (0 - count))
+				sum += _tree[count];
+
+			return sum;
+		}
+
+		Engine *_engine; //not a reference, so that the selector is assignable
+		std::vector<double> _weights;
+		std::vector<double> _tree; //1-based, node i sums the weights of the (i & -i) indices ending at i
+	};
+
+} //ns Ctoolhu::Random
+
+#endif //file guard
@@ -4,16 +4,150 @@
 #ifndef _ctoolhu_std_ext_included_
 #define _ctoolhu_std_ext_included_
 
+#include "container/search.hpp"
 #include <algorithm>
+#include <bit>
 #include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iterator>
 #include <numeric>
+#include <optional>
 #include <ranges>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 //this is a std extension by purpose, so stays outside the Ctoolhu namespace
 
 namespace std_ext {
 
+	namespace Private {
+
+		template <std::size_t Size> struct unsigned_lane {};
+		template <> struct unsigned_lane<1> { using type = std::uint8_t; };
+		template <> struct unsigned_lane<2> { using type = std::uint16_t; };
+		template <> struct unsigned_lane<4> { using type = std::uint32_t; };
+		template <> struct unsigned_lane<8> { using type = std::uint64_t; };
+
+		//Lane type the search kernels compare elements of type T as, void if they can't.
+		//Integers, enums and types backed by an integer (e.g. TypeSafe::Id) compare bitwise, floating point numbers as numbers.
+		template <class T>
+		struct search_lane { using type = void; };
+
+		template <class T> requires (std::is_integral_v<T> || std::is_enum_v<T>) && (sizeof(T) <= 8)
+		struct search_lane<T> { using type = typename unsigned_lane<sizeof(T)>::type; };
+
+		template <class T> requires requires(T t) { { underlying_value(t) } -> std::integral; }
+			&& std::is_trivially_copyable_v<T> && (sizeof(T) == sizeof(decltype(underlying_value(std::declval<T>()))))
+		struct search_lane<T> { using type = typename unsigned_lane<sizeof(T)>::type; };
+
+		template <> struct search_lane<float> { using type = float; };
+		template <> struct search_lane<double> { using type = double; };
+
+		template <class T>
+		using search_lane_t = typename search_lane<T>::type;
+
+		template <class Container>
+		using element_t = std::ranges::range_value_t<const Container>;
+
+		//containers searched by the vectorized kernels
+		template <class Container>
+		concept LaneSearchable = std::ranges::contiguous_range<const Container> && std::ranges::sized_range<const Container>
+			&& !std::is_void_v<search_lane_t<element_t<Container>>>;
+
+		template <class T>
+		concept StandardInteger = std::integral<T> && !std::same_as<T, bool> && !std::same_as<T, char> && !std::same_as<T, wchar_t>
+			&& !std::same_as<T, char8_t> && !std::same_as<T, char16_t> && !std::same_as<T, char32_t>;
+
+		//the value as a lane equal exactly to the elements the value compares equal to, if there is such a lane
+		template <class Element, class Value>
+		constexpr std::optional<search_lane_t<Element>> ToLane(const Value &v) noexcept
+		{
+			using lane_t = search_lane_t<Element>;
+			if constexpr (std::same_as<Value, Element>)
+				return std::bit_cast<lane_t>(v);
+			else if constexpr (StandardInteger<Element> && StandardInteger<Value>) {
+				if (std::in_range<Element>(v)) //otherwise the comparison converts the element rather than the value
+					return std::bit_cast<lane_t>(static_cast<Element>(v));
+			}
+			return std::nullopt;
+		}
+
+		template <class Container, class Lane>
+		std::size_t FindLane(const Container &c, Lane lane) noexcept
+		{
+			return Ctoolhu::Container::Private::SearchKernels::Find(std::ranges::data(c), std::ranges::size(c), lane);
+		}
+
+		//std::lower_bound, branchless for random access containers
+		template <class Container, class T, class Compare>
+		constexpr auto LowerBound(const Container &c, const T &v, Compare comp)
+		{
+			if constexpr (std::ranges::random_access_range<const Container>)
+				return Ctoolhu::Container::Private::SearchKernels::PartitionPoint(std::cbegin(c), std::ranges::distance(c), [&](const auto &e) { return comp(e, v); });
+			else
+				return std::lower_bound(std::cbegin(c), std::cend(c), v, comp);
+		}
+
+		//std::upper_bound, branchless for random access containers
+		template <class Container, class T, class Compare>
+		constexpr auto UpperBound(const Container &c, const T &v, Compare comp)
+		{
+			if constexpr (std::ranges::random_access_range<const Container>)
+				return Ctoolhu::Container::Private::SearchKernels::PartitionPoint(std::cbegin(c), std::ranges::distance(c), [&](const auto &e) { return !comp(v, e); });
+			else
+				return std::upper_bound(std::cbegin(c), std::cend(c), v, comp);
+		}
+
+		//sorted containers up to this size are counted by a linear scan rather than two binary searches
+		constexpr std::size_t linear_count_limit{128};
+
+		//contains_any builds a set when both sides have at least this many elements
+		constexpr std::size_t set_probe_threshold{32};
+
+		template <class HayContainer, class NeedleContainer>
+		concept SetProbeable = std::ranges::sized_range<const HayContainer> && std::ranges::sized_range<const NeedleContainer>
+			&& std::same_as<element_t<HayContainer>, element_t<NeedleContainer>>
+			&& std::unsigned_integral<search_lane_t<element_t<HayContainer>>>;
+
+		//Builds a set of the lanes of the smaller container and probes it with the larger one:
+		//a bitset if the lanes span a range not much wider than their count, a hash set otherwise.
+		template <class Smaller, class Larger>
+		bool ProbeSet(const Smaller &smaller, const Larger &larger)
+		{
+			using lane_t = search_lane_t<element_t<Smaller>>;
+			auto const lane = [](const element_t<Smaller> &e) { return std::bit_cast<lane_t>(e); };
+			auto const [lowest, highest] = std::ranges::minmax(smaller | std::views::transform(lane));
+			auto const words = static_cast<std::uint64_t>(highest - lowest) / 64 + 1;
+			if (words <= std::ranges::size(smaller)) {
+				std::vector<std::uint64_t> bits(static_cast<std::size_t>(words));
+				for (auto const &e : smaller) {
+					auto const offset = static_cast<std::uint64_t>(lane(e) - lowest);
+					bits[offset / 64] |= std::uint64_t{1} << (offset % 64);
+				}
+				return std::ranges::any_of(larger, [&](const auto &e) {
+					auto const l = lane(e);
+					if (l < lowest || l > highest)
+						return false;
+
+					auto const offset = static_cast<std::uint64_t>(l - lowest);
+					return (bits[offset / 64] >> (offset % 64) & 1) != 0;
+				});
+			}
+			std::unordered_set<lane_t> set;
+			set.reserve(std::ranges::size(smaller));
+			for (auto const &e : smaller)
+				set.insert(lane(e));
+
+			return std::ranges::any_of(larger, [&](const auto &e) { return set.contains(lane(e)); });
+		}
+
+	} //ns Private
+
 	template <class Container, typename Sum>
 	constexpr Sum accumulate(const Container &c, Sum init)
 	{
@@ -29,15 +163,24 @@ namespace std_ext {
 	template <class LookupContainer, class T>
 	constexpr bool binary_search(const LookupContainer &c, const T &v)
 	{
-		return std::binary_search(std::cbegin(c), std::cend(c), v);
+		auto const it = Private::LowerBound(c, v, std::less<>{});
+		return it != std::cend(c) && !(v < *it);
 	}
 
 	template <class Container, class Value>
 	constexpr auto count_sorted(const Container &c, Value v)
 	{
-		return std::distance(std::lower_bound(std::cbegin(c), std::cend(c), v), std::upper_bound(std::cbegin(c), std::cend(c), v));
+		if constexpr (Private::LaneSearchable<Container>) {
+			if (!std::is_constant_evaluated() && std::ranges::size(c) <= Private::linear_count_limit) {
+				if (auto const lane = Private::ToLane<Private::element_t<Container>>(v))
+					return static_cast<std::iter_difference_t<decltype(std::cbegin(c))>>(
+						Ctoolhu::Container::Private::SearchKernels::Count(std::ranges::data(c), std::ranges::size(c), *lane));
+			}
+		}
+		return std::distance(Private::LowerBound(c, v, std::less<>{}), Private::UpperBound(c, v, std::less<>{}));
 	}
 
+	//O(n) per value, so to build a sorted container from many values use flat_set or flat_map and their insert_range
 	template<class Container, class Value>
 	auto insert_sorted(Container& c, const Value &v)
 	{
@@ -63,7 +206,7 @@ namespace std_ext {
 	auto binary_find(const LookupContainer &c, const T &val, Compare comp = {})
 	{
 		auto last = std::cend(c);
-		auto first = std::lower_bound(std::cbegin(c), last, val, comp);
+		auto first = Private::LowerBound(c, val, comp);
 		return first != last && !comp(val, *first) ? first : last;
 	}
 
@@ -81,15 +224,28 @@ namespace std_ext {
 		return std::move(std::begin(s), std::end(s), std::back_inserter(d));
 	}
 
+	//contiguous containers of integers, enums, ids or floating point numbers are searched by vectorized kernels
 	template <class LookupContainer, class Value>
 	constexpr bool contains(const LookupContainer &c, Value &&v)
 	{
+		if constexpr (Private::LaneSearchable<LookupContainer>) {
+			if (!std::is_constant_evaluated()) {
+				if (auto const lane = Private::ToLane<Private::element_t<LookupContainer>>(std::as_const(v)))
+					return Private::FindLane(c, *lane) < std::ranges::size(c);
+			}
+		}
 		return std::ranges::find(c, std::forward<Value>(v)) != std::cend(c);
 	}
 
+	//when both containers are large and hold the same integers, enums or ids, the smaller one is put in a set probed by the other
 	template <class HayContainer, class NeedleContainer>
 	constexpr bool contains_any(const HayContainer &haystack, const NeedleContainer &needles)
 	{
+		if constexpr (Private::SetProbeable<HayContainer, NeedleContainer>) {
+			auto const haySize = std::ranges::size(haystack), needleCount = std::ranges::size(needles);
+			if (!std::is_constant_evaluated() && std::min<std::size_t>(haySize, needleCount) >= Private::set_probe_threshold)
+				return haySize < needleCount ? Private::ProbeSet(haystack, needles) : Private::ProbeSet(needles, haystack);
+		}
 		return std::ranges::any_of(needles, [&haystack](auto const &n) {
 			return contains(haystack, n);
 		});
@@ -98,6 +254,10 @@ namespace std_ext {
 	template <class Container, class Value>
 	auto erase(Container &c, const Value &v)
 	{
+		if constexpr (Private::LaneSearchable<Container>) {
+			if (auto const lane = Private::ToLane<Private::element_t<Container>>(v))
+				return c.erase(std::begin(c) + Private::FindLane(c, *lane));
+		}
 		return c.erase(std::find(std::begin(c), std::end(c), v));
 	}
 
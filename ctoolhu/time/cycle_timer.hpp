@@ -0,0 +1,140 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_time_cycle_timer_included_
+#define _ctoolhu_time_cycle_timer_included_
+
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CTOOLHU_TSC
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define CTOOLHU_TSC
+#endif
+
+namespace Ctoolhu::Time {
+
+	//Clock reading the CPU's time stamp counter, which takes a few nanoseconds compared to tens for steady_clock.
+	//Where there is no time stamp counter (e.g. Emscripten), the ticks are those of steady_clock.
+	//The counter is assumed to be invariant (constant rate, synchronized among cores), as on all current x86 processors.
+	class CycleClock {
+
+	  public:
+
+		using ticks_t = std::int64_t;
+
+		//ticks since an arbitrary point, not ordered with respect to surrounding instructions
+		static ticks_t Now() noexcept
+		{
+#ifdef CTOOLHU_TSC
+			return static_cast<ticks_t>(__rdtsc());
+#else
+			return static_cast<ticks_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+		}
+
+		//ticks since an arbitrary point, read only after all preceding instructions have completed
+		static ticks_t NowAfter() noexcept
+		{
+#ifdef CTOOLHU_TSC
+			unsigned int processor;
+			return static_cast<ticks_t>(__rdtscp(&processor));
+#else
+			return Now();
+#endif
+		}
+
+		//nanoseconds per tick, measured against steady_clock on the first call (takes about 10 ms)
+		static double NanosecondsPerTick()
+		{
+			static double const ratio{calibrate()};
+			return ratio;
+		}
+
+		//makes sure the calibration doesn't happen in the middle of a measured section
+		static void Calibrate()
+		{
+			NanosecondsPerTick();
+		}
+
+		template <class Duration = std::chrono::nanoseconds>
+		static Duration ToDuration(ticks_t ticks)
+		{
+			std::chrono::duration<double, std::nano> const nanoseconds{static_cast<double>(ticks) * NanosecondsPerTick()};
+			return std::chrono::duration_cast<Duration>(nanoseconds);
+		}
+
+	  private:
+
+		static double calibrate()
+		{
+#ifdef CTOOLHU_TSC
+			using namespace std::chrono;
+			auto const startTime = steady_clock::now();
+			auto const startTicks = NowAfter();
+			auto endTime = startTime;
+			while (endTime - startTime < milliseconds{10})
+				endTime = steady_clock::now();
+
+			auto const endTicks = NowAfter();
+			return duration<double, std::nano>{endTime - startTime}.count() / static_cast<double>(endTicks - startTicks);
+#else
+			using period_t = std::ratio_divide<std::chrono::steady_clock::period, std::nano>;
+			return static_cast<double>(period_t::num) / period_t::den;
+#endif
+		}
+	};
+
+	//Tool for measuring short sections by CPU cycles, cheap enough to wrap around sub-microsecond sections millions of times.
+	//Accumulate raw ticks, and convert them to a duration only when reporting, e.g.
+	//
+	//	CycleClock::ticks_t spent{0};
+	//	for (...) {
+	//		CycleTimer timer;
+	//		...
+	//		spent += timer.ElapsedTicks();
+	//	}
+	//	log(CycleClock::ToDuration<std::chrono::microseconds>(spent));
+	//
+	template <
+		class Resolution = std::chrono::nanoseconds //resolution of the reported durations
+	>
+	class CycleTimer {
+
+	  public:
+
+		using duration_t = Resolution;
+		using clock_t = CycleClock;
+
+		CycleTimer() noexcept
+		{
+			StartClock();
+		}
+
+		void StartClock() noexcept
+		{
+			_startTicks = clock_t::Now();
+		}
+
+		clock_t::ticks_t ElapsedTicks() const noexcept
+		{
+			return clock_t::NowAfter() - _startTicks;
+		}
+
+		duration_t ElapsedTime() const
+		{
+			return clock_t::ToDuration<duration_t>(ElapsedTicks());
+		}
+
+	  private:
+
+		clock_t::ticks_t _startTicks;
+	};
+
+} //ns Ctoolhu::Time
+
+#endif //file guard
@@ -0,0 +1,268 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_time_histogram_included_
+#define _ctoolhu_time_histogram_included_
+
+#include "timer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace Ctoolhu::Time {
+
+	namespace Private::LogBuckets {
+
+		//Values below sub_count have a bucket each, every further power of two is split into sub_count buckets,
+		//so a bucket is never wider than 1/128 of its values (HDR histogram with ~2 significant digits).
+		constexpr unsigned sub_bits{7};
+		constexpr std::uint64_t sub_count{std::uint64_t{1} << sub_bits};
+
+		//values are tracked up to 2^40 ns (about 18 minutes), longer ones fall into the last bucket
+		constexpr unsigned range_bits{40};
+		constexpr std::uint64_t max_value{(std::uint64_t{1} << range_bits) - 1};
+		constexpr std::size_t count{(range_bits - sub_bits + 1) * sub_count};
+
+		constexpr std::size_t Index(std::uint64_t value) noexcept
+		{
+			value = std::min(value, max_value);
+			if (value < sub_count)
+				return static_cast<std::size_t>(value);
+
+			auto const shift = static_cast<unsigned>(std::bit_width(value)) - sub_bits - 1;
+			return static_cast<std::size_t>(shift * sub_count + (value >> shift));
+		}
+
+		//highest value falling into the bucket
+		constexpr std::uint64_t HighestEquivalent(std::size_t index) noexcept
+		{
+			if (index < sub_count)
+				return index;
+
+			auto const shift = index / sub_count - 1;
+			auto const mantissa = index % sub_count + sub_count;
+			return ((mantissa + 1) << shift) - 1;
+		}
+
+		static_assert(Index(max_value) == count - 1);
+		static_assert(HighestEquivalent(count - 1) == max_value);
+
+		template <class Rep, class Period>
+		std::uint64_t Nanoseconds(std::chrono::duration<Rep, Period> duration) noexcept
+		{
+			auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+			return ns > 0 ? static_cast<std::uint64_t>(ns) : 0;
+		}
+
+	} //ns Private::LogBuckets
+
+	//Log-bucketed latency histogram of fixed size, for a single thread or for a merged view of a LatencyHistogram.
+	//Percentiles are reported as the highest value of the bucket they fall into, i.e. within 1% above the exact value.
+	class LatencySnapshot {
+
+	  public:
+
+		using duration_t = std::chrono::nanoseconds;
+
+		LatencySnapshot()
+			: _buckets(Private::LogBuckets::count) {}
+
+		template <class Rep, class Period>
+		void Record(std::chrono::duration<Rep, Period> latency) noexcept
+		{
+			auto const ns = Private::LogBuckets::Nanoseconds(latency);
+			++_buckets[Private::LogBuckets::Index(ns)];
+			++_count;
+			_sum += ns;
+			_min = std::min(_min, ns);
+			_max = std::max(_max, ns);
+		}
+
+		//adds the samples of the other histogram
+		LatencySnapshot &operator+=(const LatencySnapshot &other) noexcept
+		{
+			for (std::size_t i{0}; i < _buckets.size(); ++i)
+				_buckets[i] += other._buckets[i];
+
+			_count += other._count;
+			_sum += other._sum;
+			_min = std::min(_min, other._min);
+			_max = std::max(_max, other._max);
+			return *this;
+		}
+
+		//latency which given percentage of the samples doesn't exceed, e.g. Percentile(99.9)
+		duration_t Percentile(double percent) const noexcept
+		{
+			assert(percent >= 0 && percent <= 100 && "percentile out of range");
+			if (_count == 0)
+				return duration_t::zero();
+
+			auto const rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(percent / 100 * static_cast<double>(_count))));
+			std::uint64_t seen{0};
+			for (std::size_t i{0}; i < _buckets.size(); ++i) {
+				seen += _buckets[i];
+				if (seen >= rank) {
+					auto const value = Private::LogBuckets::HighestEquivalent(i);
+					return duration_t(static_cast<duration_t::rep>(hasExtremes() ? std::clamp(value, _min, _max) : value));
+				}
+			}
+			return Max();
+		}
+
+		std::uint64_t Count() const noexcept { return _count; }
+		duration_t Min() const noexcept { return duration_t(hasExtremes() ? static_cast<duration_t::rep>(_min) : 0); }
+		duration_t Max() const noexcept { return duration_t(static_cast<duration_t::rep>(_max)); }
+		duration_t Mean() const noexcept { return duration_t(_count ? static_cast<duration_t::rep>(_sum / _count) : 0); }
+
+		void Clear() noexcept
+		{
+			std::fill(_buckets.begin(), _buckets.end(), 0);
+			_count = _sum = _max = 0;
+			_min = std::numeric_limits<std::uint64_t>::max();
+		}
+
+	  private:
+
+		friend class LatencyHistogram;
+
+		//a snapshot taken while a sample is being recorded may count it before its extremes are updated
+		bool hasExtremes() const noexcept { return _min <= _max; }
+
+		std::vector<std::uint64_t> _buckets;
+		std::uint64_t _count{0};
+		std::uint64_t _sum{0};
+		std::uint64_t _min{std::numeric_limits<std::uint64_t>::max()};
+		std::uint64_t _max{0};
+	};
+
+	//Log-bucketed latency histogram recorded concurrently by any number of threads, e.g.
+	//
+	//	Time::LatencyHistogram latencies;
+	//	...
+	//	{
+	//		Time::HistogramTimer timer{latencies};
+	//		HandleRequest();
+	//	}
+	//	...
+	//	auto const snapshot = latencies.Snapshot();
+	//	std::cout << snapshot.Percentile(50) << ' ' << snapshot.Percentile(99) << ' ' << snapshot.Percentile(99.9);
+	//
+	//Recording is O(1) and lock-free. Each thread records into one of a fixed number of shards picked by the thread,
+	//so that threads don't fight over the same cache lines.
+	class LatencyHistogram {
+
+	  public:
+
+		//the shard count is rounded up to a power of two, by default one per hardware thread
+		explicit LatencyHistogram(std::size_t shards = std::thread::hardware_concurrency())
+			: _shardMask{std::bit_ceil(std::max<std::size_t>(shards, 1)) - 1}
+			, _shards{std::make_unique<Shard[]>(_shardMask + 1)} {}
+
+		LatencyHistogram(const LatencyHistogram &) = delete;
+		LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+		template <class Rep, class Period>
+		void Record(std::chrono::duration<Rep, Period> latency) noexcept
+		{
+			auto const ns = Private::LogBuckets::Nanoseconds(latency);
+			auto &shard = _shards[threadIndex() & _shardMask];
+			shard.buckets[Private::LogBuckets::Index(ns)].fetch_add(1, std::memory_order_relaxed);
+			shard.sum.fetch_add(ns, std::memory_order_relaxed);
+			update(shard.min, ns, [](auto a, auto b) { return a < b; });
+			update(shard.max, ns, [](auto a, auto b) { return a > b; });
+		}
+
+		//merges the shards, samples recorded concurrently may or may not be included
+		LatencySnapshot Snapshot() const
+		{
+			LatencySnapshot snapshot;
+			for (std::size_t s{0}; s <= _shardMask; ++s) {
+				auto const &shard = _shards[s];
+				for (std::size_t i{0}; i < Private::LogBuckets::count; ++i) {
+					auto const samples = shard.buckets[i].load(std::memory_order_relaxed);
+					snapshot._buckets[i] += samples;
+					snapshot._count += samples;
+				}
+				snapshot._sum += shard.sum.load(std::memory_order_relaxed);
+				snapshot._min = std::min(snapshot._min, shard.min.load(std::memory_order_relaxed));
+				snapshot._max = std::max(snapshot._max, shard.max.load(std::memory_order_relaxed));
+			}
+			return snapshot;
+		}
+
+		void Reset() noexcept
+		{
+			for (std::size_t s{0}; s <= _shardMask; ++s) {
+				auto &shard = _shards[s];
+				for (auto &bucket : shard.buckets)
+					bucket.store(0, std::memory_order_relaxed);
+
+				shard.sum.store(0, std::memory_order_relaxed);
+				shard.min.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+				shard.max.store(0, std::memory_order_relaxed);
+			}
+		}
+
+	  private:
+
+		struct alignas(64) Shard {
+			std::atomic<std::uint64_t> buckets[Private::LogBuckets::count]{};
+			alignas(64) std::atomic<std::uint64_t> sum{0};
+			std::atomic<std::uint64_t> min{std::numeric_limits<std::uint64_t>::max()};
+			std::atomic<std::uint64_t> max{0};
+		};
+
+		static std::size_t threadIndex() noexcept
+		{
+			static std::atomic<std::size_t> nextIndex{0};
+			thread_local std::size_t const index{nextIndex.fetch_add(1, std::memory_order_relaxed)};
+			return index;
+		}
+
+		//stores the value if it is better than the current one, which is rare after the first few samples
+		template <class Better>
+		static void update(std::atomic<std::uint64_t> &current, std::uint64_t value, Better better) noexcept
+		{
+			auto seen = current.load(std::memory_order_relaxed);
+			while (better(value, seen) && !current.compare_exchange_weak(seen, value, std::memory_order_relaxed));
+		}
+
+		std::size_t const _shardMask;
+		std::unique_ptr<Shard[]> _shards;
+	};
+
+	//records the time elapsed since its construction into the histogram when the scope ends
+	template <class Histogram = LatencyHistogram>
+	class HistogramTimer : public Timer<std::chrono::nanoseconds> {
+
+	  public:
+
+		explicit HistogramTimer(Histogram &histogram) noexcept
+			: _histogram{histogram} {}
+
+		HistogramTimer(const HistogramTimer &) = delete;
+		HistogramTimer &operator=(const HistogramTimer &) = delete;
+
+		~HistogramTimer()
+		{
+			_histogram.Record(ElapsedTime());
+		}
+
+	  private:
+
+		Histogram &_histogram;
+	};
+
+} //ns Ctoolhu::Time
+
+#endif //file guard
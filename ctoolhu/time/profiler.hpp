@@ -0,0 +1,369 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_time_profiler_included_
+#define _ctoolhu_time_profiler_included_
+
+#include "cycle_timer.hpp"
+#include "../singleton/holder.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+//Marks the rest of the enclosing scope as a named profiling zone, e.g.
+//
+//	void Solve()
+//	{
+//		CTOOLHU_PROFILE_SCOPE("solve");
+//		...
+//	}
+//
+//The zones are recorded only when CTOOLHU_PROFILE is defined, otherwise the macro expands to nothing.
+//The name must be a string literal (or otherwise outlive the profile).
+#ifdef CTOOLHU_PROFILE
+#define CTOOLHU_PROFILE_CONCAT_(a, b) a##b
+#define CTOOLHU_PROFILE_CONCAT(a, b) CTOOLHU_PROFILE_CONCAT_(a, b)
+#define CTOOLHU_PROFILE_SCOPE(name) ::Ctoolhu::Time::ProfileZone CTOOLHU_PROFILE_CONCAT(_ctoolhuProfileZone, __LINE__){name}
+#else
+#define CTOOLHU_PROFILE_SCOPE(name) ((void)0)
+#endif
+
+namespace Ctoolhu::Time {
+
+	//aggregated statistics of a zone called from the same chain of zones
+	struct ProfileNode {
+		std::string name;
+		std::uint64_t count{0};
+		std::chrono::nanoseconds total{0};
+		std::chrono::nanoseconds self{0};	//total minus the time spent in nested zones
+		std::chrono::nanoseconds max{0};
+		std::vector<ProfileNode> children;
+	};
+
+	namespace Private {
+
+		struct ZoneRecord {
+			const char *name;
+			CycleClock::ticks_t start;
+			CycleClock::ticks_t end;
+			std::uint32_t depth;
+		};
+
+		//Zones completed by a single thread.
+		//Only the owning thread appends to it, without locking, while any thread can read what has been published.
+		//The readers are serialized by the registry, which also lets them free the chunks discarded by a reset.
+		class ZoneLog {
+
+			static constexpr std::size_t chunk_size{4096};
+
+			struct Chunk {
+				ZoneRecord records[chunk_size];
+				std::atomic<Chunk *> next{nullptr};
+			};
+
+		  public:
+
+			explicit ZoneLog(std::uint32_t thread)
+				: _thread{thread}, _head{new Chunk}, _tail{_head} {}
+
+			ZoneLog(const ZoneLog &) = delete;
+			ZoneLog &operator=(const ZoneLog &) = delete;
+
+			~ZoneLog()
+			{
+				for (auto chunk = _head; chunk;)
+					delete std::exchange(chunk, chunk->next.load(std::memory_order_relaxed));
+			}
+
+			//called by the owning thread only
+			void Append(const ZoneRecord &record)
+			{
+				if (_used == chunk_size) {
+					auto chunk = new Chunk;
+					_tail->next.store(chunk, std::memory_order_release);
+					_tail = chunk;
+					_used = 0;
+				}
+				_tail->records[_used++] = record;
+				_count.store(_count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			}
+
+			//visits the published records which haven't been discarded
+			template <class Visitor>
+			void ForEach(Visitor visit) const
+			{
+				auto const count = _count.load(std::memory_order_acquire);
+				auto i = std::max(_discarded, _headFirst);
+				auto chunk = _head;
+				auto chunkFirst = _headFirst;
+				for (; i < count; ++i) {
+					if (i - chunkFirst == chunk_size) {
+						chunk = chunk->next.load(std::memory_order_acquire);
+						chunkFirst += chunk_size;
+					}
+					visit(chunk->records[i - chunkFirst]);
+				}
+			}
+
+			//discards the published records, freeing the chunks the owning thread has filled and left
+			void Discard() noexcept
+			{
+				_discarded = _count.load(std::memory_order_acquire);
+				while (_headFirst + chunk_size <= _discarded) {
+					auto const next = _head->next.load(std::memory_order_acquire);
+					if (!next)
+						break; //still the tail the owning thread appends to
+
+					delete std::exchange(_head, next);
+					_headFirst += chunk_size;
+				}
+			}
+
+			//called by the owning thread when it ends
+			void Exit() noexcept { _exited.store(true, std::memory_order_release); }
+
+			bool Exited() const noexcept { return _exited.load(std::memory_order_acquire); }
+
+			std::uint32_t Thread() const noexcept { return _thread; }
+
+			std::uint32_t depth{0}; //of the zones currently open in the owning thread
+
+		  private:
+
+			std::uint32_t const _thread;
+
+			//used by the readers only
+			Chunk *_head;
+			std::size_t _headFirst{0};	//index of the first record in the head chunk
+			std::size_t _discarded{0};	//records before this index are discarded
+
+			//used by the owning thread only
+			Chunk *_tail;
+			std::size_t _used{0};		//records in the tail chunk
+
+			std::atomic<std::size_t> _count{0};
+			std::atomic<bool> _exited{false};
+		};
+
+		//owns the zone logs of all threads, so that the records outlive the threads
+		class ProfileRegistry {
+
+		  public:
+
+			ProfileRegistry(const ProfileRegistry &) = delete;
+			ProfileRegistry &operator=(const ProfileRegistry &) = delete;
+
+			ZoneLog *Register()
+			{
+				std::lock_guard lock{_mutex};
+				return _logs.emplace_back(std::make_unique<ZoneLog>(_nextThread++)).get();
+			}
+
+			template <class Visitor>
+			void ForEachLog(Visitor visit) const
+			{
+				std::lock_guard lock{_mutex};
+				for (auto const &log : _logs)
+					visit(*log);
+			}
+
+			//discards all records, destroying the logs of the threads which have ended
+			void Reset()
+			{
+				std::lock_guard lock{_mutex};
+				std::erase_if(_logs, [](const auto &log) { return log->Exited(); });
+				for (auto const &log : _logs)
+					log->Discard();
+			}
+
+		  private:
+
+			friend struct Loki::CreateUsingNew<ProfileRegistry>;
+			ProfileRegistry() = default;
+
+			std::vector<std::unique_ptr<ZoneLog>> _logs;
+			std::uint32_t _nextThread{0};
+			mutable std::mutex _mutex;
+		};
+
+		using SingleProfileRegistry = Singleton::Holder<ProfileRegistry>;
+
+		inline ZoneLog &ThisThreadZoneLog()
+		{
+			//marks the log when the thread ends, so that the next reset can free it
+			struct Owner {
+				ZoneLog *log{SingleProfileRegistry::Instance().Register()};
+				~Owner() { log->Exit(); }
+			};
+			thread_local Owner owner;
+			return *owner.log;
+		}
+
+		inline void Aggregate(ProfileNode &node, std::chrono::nanoseconds duration)
+		{
+			++node.count;
+			node.total += duration;
+			node.self += duration;
+			node.max = std::max(node.max, duration);
+		}
+
+		inline ProfileNode &ChildNode(ProfileNode &parent, const char *name)
+		{
+			auto it = std::find_if(parent.children.begin(), parent.children.end(), [name](const ProfileNode &child) { return child.name == name; });
+			if (it != parent.children.end())
+				return *it;
+
+			auto &child = parent.children.emplace_back();
+			child.name = name;
+			return child;
+		}
+
+		inline void WriteJsonString(std::ostream &out, const char *text)
+		{
+			out << '"';
+			for (; *text; ++text) {
+				if (*text == '"' || *text == '\\')
+					out << '\\';
+
+				out << *text;
+			}
+			out << '"';
+		}
+
+	} //ns Private
+
+	//Zone measured from its construction to its destruction, used by CTOOLHU_PROFILE_SCOPE.
+	//Costs two reads of the time stamp counter and an append to the thread's own log.
+	//Allocating the first log of a thread may throw, while a zone ending without the memory to log it is dropped.
+	class ProfileZone {
+
+	  public:
+
+		explicit ProfileZone(const char *name)
+			: _log{Private::ThisThreadZoneLog()}, _name{name}, _depth{_log.depth++}, _start{CycleClock::Now()} {}
+
+		ProfileZone(const ProfileZone &) = delete;
+		ProfileZone &operator=(const ProfileZone &) = delete;
+
+		~ProfileZone()
+		{
+			auto const end = CycleClock::Now();
+			--_log.depth;
+			try {
+				_log.Append({_name, _start, end, _depth});
+			}
+			catch (const std::bad_alloc &) {
+				//the zone is dropped rather than throwing from the destructor
+			}
+		}
+
+	  private:
+
+		Private::ZoneLog &_log;
+		const char *_name;
+		std::uint32_t _depth;
+		CycleClock::ticks_t _start;
+	};
+
+	//Aggregates the zones recorded so far by all threads into a call tree, whose root is a nameless node holding the outermost zones.
+	//Zones still open are not included.
+	inline ProfileNode ProfileTree()
+	{
+		ProfileNode root;
+		Private::SingleProfileRegistry::Instance().ForEachLog([&root](const Private::ZoneLog &log) {
+			std::vector<Private::ZoneRecord> records;
+			log.ForEach([&records](const Private::ZoneRecord &record) { records.push_back(record); });
+
+			//the records are appended as the zones end, so order them by start to visit the parents before their children
+			std::sort(records.begin(), records.end(), [](const auto &a, const auto &b) {
+				return a.start != b.start ? a.start < b.start : a.depth < b.depth;
+			});
+			std::vector<std::pair<std::uint32_t, ProfileNode *>> open; //chain of zones enclosing the current one
+			for (auto const &record : records) {
+				while (!open.empty() && open.back().first >= record.depth)
+					open.pop_back();
+
+				auto &parent = open.empty() ? root : *open.back().second;
+				auto &node = Private::ChildNode(parent, record.name);
+				auto const duration = CycleClock::ToDuration(record.end - record.start);
+				Private::Aggregate(node, duration);
+				if (!open.empty())
+					parent.self -= duration;
+
+				open.emplace_back(record.depth, &node);
+			}
+		});
+		for (auto const &child : root.children)
+			root.total += child.total;
+
+		return root;
+	}
+
+	//Writes the zones recorded so far by all threads in the Chrome trace event format (for chrome://tracing or Perfetto).
+	inline void WriteChromeTrace(std::ostream &out)
+	{
+		auto first = CycleClock::Now();
+		Private::SingleProfileRegistry::Instance().ForEachLog([&first](const Private::ZoneLog &log) {
+			log.ForEach([&first](const Private::ZoneRecord &record) { first = std::min(first, record.start); });
+		});
+
+		auto const microseconds = [](CycleClock::ticks_t ticks) {
+			return static_cast<double>(ticks) * CycleClock::NanosecondsPerTick() / 1000;
+		};
+		auto const flags = out.flags();
+		auto const precision = out.precision();
+		out << std::fixed << std::setprecision(3);
+		out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+		bool separate{false};
+		Private::SingleProfileRegistry::Instance().ForEachLog([&](const Private::ZoneLog &log) {
+			log.ForEach([&](const Private::ZoneRecord &record) {
+				out << (separate ? ",\n" : "\n") << "{\"name\":";
+				Private::WriteJsonString(out, record.name);
+				out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << log.Thread()
+					<< ",\"ts\":" << microseconds(record.start - first)
+					<< ",\"dur\":" << microseconds(record.end - record.start) << '}';
+				separate = true;
+			});
+		});
+		out << "\n]}\n";
+		out.flags(flags);
+		out.precision(precision);
+	}
+
+	//Forgets the zones recorded so far by all threads and frees their memory.
+	//The zones of threads which have ended are reported until the reset, which then frees their logs too.
+	inline void ResetProfile()
+	{
+		Private::SingleProfileRegistry::Instance().Reset();
+	}
+
+	//prints the call tree indented by nesting, with the statistics of each zone
+	inline std::ostream &operator<<(std::ostream &out, const ProfileNode &node)
+	{
+		auto const print = [&out](const ProfileNode &n, int indent, auto &self) -> void {
+			out << std::string(indent * 2, ' ') << std::left << std::setw(std::max(1, 40 - indent * 2)) << n.name << std::right
+				<< " count " << std::setw(10) << n.count
+				<< " total " << std::setw(14) << n.total.count() << " ns"
+				<< " self " << std::setw(14) << n.self.count() << " ns"
+				<< " max " << std::setw(12) << n.max.count() << " ns\n";
+			for (auto const &child : n.children)
+				self(child, indent + 1, self);
+		};
+		for (auto const &child : node.children)
+			print(child, 0, print);
+
+		return out;
+	}
+
+} //ns Ctoolhu::Time
+
+#endif //file guard
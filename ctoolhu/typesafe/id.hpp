@@ -5,6 +5,7 @@
 #define _ctoolhu_typesafe_id_included_
 
 #include <compare>
+#include <functional>
 #include <iosfwd>
 #include <type_traits>
 
@@ -25,6 +26,12 @@ namespace Ctoolhu::TypeSafe {
 				return out << storage._id;
 			}
 
+			//access to the stored value regardless of the conversion policy (for generic code like containers indexed by ids)
+			friend constexpr IdType underlying_value(Storage storage) noexcept
+			{
+				return storage._id;
+			}
+
 		  protected:
 
 			constexpr Storage() noexcept = default;
@@ -102,4 +109,14 @@ namespace Ctoolhu::TypeSafe {
 
 } //ns Ctoolhu::TypeSafe
 
+//ids hash as their underlying value, so they can be used as keys of unordered containers
+template <class RequestingObject, typename IdType, template <typename> class ConversionPolicy>
+struct std::hash<Ctoolhu::TypeSafe::Id<RequestingObject, IdType, ConversionPolicy>> {
+
+	std::size_t operator()(Ctoolhu::TypeSafe::Id<RequestingObject, IdType, ConversionPolicy> id) const noexcept
+	{
+		return std::hash<IdType>{}(underlying_value(id));
+	}
+};
+
 #endif //file guard
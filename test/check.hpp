@@ -0,0 +1,19 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+#ifndef _ctoolhu_test_check_included_
+#define _ctoolhu_test_check_included_
+
+#include <cstdio>
+#include <cstdlib>
+
+//like assert, but not compiled out in release builds
+#define CTOOLHU_CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			std::exit(EXIT_FAILURE); \
+		} \
+	} while (false)
+
+#endif //file guard
@@ -0,0 +1,87 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+// Tests of the event subscriptions and captures.
+
+#include "check.hpp"
+#include <ctoolhu/event/aggregator.hpp>
+#include <ctoolhu/event/firer.hpp>
+#include <ctoolhu/event/recorder.hpp>
+#include <ctoolhu/event/replayer.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+	struct EntityMoved {
+		int entityId;
+	};
+
+} //ns
+
+template <>
+struct Ctoolhu::Event::EventKey<EntityMoved> {
+	static int get(const EntityMoved &e) noexcept { return e.entityId; }
+};
+
+namespace {
+
+	using namespace Ctoolhu::Event;
+
+	//the signals of keys whose handlers have all disconnected must not accumulate
+	void KeyedSignalsPruned()
+	{
+		Private::KeyedSignals<EntityMoved> signals;
+		int fired{0};
+		for (int id{0}; id < 10'000; ++id)
+			signals.Subscribe(id, [&fired](EntityMoved *) { ++fired; }).disconnect();
+
+		CTOOLHU_CHECK(signals.KeyCount() <= 128);
+
+		auto const kept = signals.Subscribe(-1, [&fired](EntityMoved *) { ++fired; });
+		auto const gone = signals.Subscribe(-2, [&fired](EntityMoved *) { ++fired; });
+		gone.disconnect();
+		auto const keys = signals.KeyCount();
+		EntityMoved moved{-2};
+		signals.Fire(&moved); //prunes the key
+		CTOOLHU_CHECK(signals.KeyCount() == keys - 1);
+
+		moved.entityId = -1;
+		signals.Fire(&moved);
+		CTOOLHU_CHECK(fired == 1);
+	}
+
+	//a log ending inside a record header must not replay as if it were complete
+	void TruncatedCaptureThrows()
+	{
+		auto const fileName = (std::filesystem::temp_directory_path() / "ctoolhu_test_capture").string();
+		{
+			Recorder<EntityMoved> recorder{fileName};
+			Fire(EntityMoved{1});
+			recorder.Close();
+		}
+		CTOOLHU_CHECK(Replayer<EntityMoved>{fileName}.Replay() == 1);
+
+		std::ofstream{fileName, std::ios::binary | std::ios::app}.write("\0\0\0", 3);
+		bool thrown{false};
+		try {
+			Replayer<EntityMoved>{fileName}.Replay();
+		}
+		catch (const std::runtime_error &) {
+			thrown = true;
+		}
+		CTOOLHU_CHECK(thrown);
+		std::filesystem::remove(fileName);
+	}
+
+} //ns
+
+int main()
+{
+	KeyedSignalsPruned();
+	TruncatedCaptureThrows();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,229 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+// Tests of the object pools.
+
+#include "check.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <ctoolhu/memory/concurrent_object_pool.hpp>
+#include <ctoolhu/memory/object_pool.hpp>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+	using namespace Ctoolhu::Memory;
+
+	using pool_t = ObjectPool<int, PoolThrowOnMallocErrorsPolicy>;
+
+	bool CanCreate(pool_t &pool)
+	{
+		try {
+			return static_cast<bool>(pool.make_pooled(0));
+		}
+		catch (const std::bad_alloc &) {
+			return false;
+		}
+	}
+
+	//lowering the limit below the objects alive must stop further allocations until enough are released
+	void LimitBelowLive()
+	{
+		pool_t pool;
+		std::vector<pool_t::pooled_ptr_t> live;
+		for (int i{0}; i < 10; ++i)
+			live.push_back(pool.make_pooled(i));
+
+		pool.set_limit(5);
+		CTOOLHU_CHECK(!CanCreate(pool));
+		CTOOLHU_CHECK(pool.stats().live == 10);
+
+		live.resize(5);
+		CTOOLHU_CHECK(!CanCreate(pool));
+
+		live.resize(4);
+		CTOOLHU_CHECK(CanCreate(pool));
+	}
+
+	//counts its instances alive
+	struct Counted {
+		Counted() noexcept { ++alive; }
+		~Counted() { --alive; }
+		static inline int alive{0};
+	};
+
+	//objects left alive must be destroyed with the pool, but not the free slots cached by the threads
+	void ConcurrentPoolDestroysLive()
+	{
+		{
+			ConcurrentObjectPool<Counted> pool;
+			for (int i{0}; i < 100; ++i)
+				pool.make_unique().release();
+
+			for (int i{0}; i < 10; ++i)
+				pool.make_unique(); //freed right away to the magazine of this thread
+
+			std::thread{[&pool] {
+				pool.make_unique().release();
+				pool.make_unique(); //returned to the depot when the thread ends
+			}}.join();
+			CTOOLHU_CHECK(Counted::alive == 101);
+		}
+		CTOOLHU_CHECK(Counted::alive == 0);
+	}
+
+	bool IsRegistered(const char *type, std::size_t live)
+	{
+		auto const pools = RegisteredPools();
+		return std::any_of(pools.begin(), pools.end(), [=](const PoolInfo &info) {
+			return info.type == type && info.stats.live == live;
+		});
+	}
+
+	//the concurrent pool must be registered with the objects in use, not counting the free slots cached by the threads
+	void ConcurrentPoolRegistered()
+	{
+		{
+			ConcurrentObjectPool<double> pool;
+			std::vector<ConcurrentObjectPool<double>::unique_ptr_t> live;
+			for (int i{0}; i < 100; ++i)
+				live.push_back(pool.make_unique(i));
+
+			live.erase(live.begin() + 40, live.end());
+			auto const stats = pool.stats();
+			CTOOLHU_CHECK(stats.live == 40);
+			CTOOLHU_CHECK(stats.peak >= 100);
+			CTOOLHU_CHECK(stats.capacity >= 100);
+			CTOOLHU_CHECK(IsRegistered("double", 40));
+		}
+		CTOOLHU_CHECK(!IsRegistered("double", 0));
+	}
+
+	//shared and weak pointers created by the pool must be usable after the pool is gone
+	void SharedOutlivesPool()
+	{
+		std::shared_ptr<int> shared;
+		std::weak_ptr<int> weak;
+		{
+			pool_t pool;
+			shared = pool.make_shared(42);
+			weak = pool.make_shared(7); //the control block lives on for the weak pointer
+		}
+		CTOOLHU_CHECK(*shared == 42);
+		CTOOLHU_CHECK(weak.expired());
+		shared.reset();
+		weak.reset();
+	}
+
+	//a moved-from pool must be usable again
+	void MovedFromPool()
+	{
+		pool_t pool;
+		pool.set_limit(1);
+		auto kept = pool.make_unique(1);
+		auto const moved = std::move(pool);
+		CTOOLHU_CHECK(moved.stats().live == 1 && moved.limit() == 1);
+
+		CTOOLHU_CHECK(pool.stats().live == 0);
+		CTOOLHU_CHECK(pool.limit() == pool_t::unlimited);
+		pool.shrink();
+		CTOOLHU_CHECK(*pool.make_unique(2) == 2);
+		CTOOLHU_CHECK(*pool.make_shared(3) == 3);
+		pool.set_limit(0);
+		CTOOLHU_CHECK(!CanCreate(pool));
+		CTOOLHU_CHECK(*kept == 1);
+		kept.reset(); //before the pool it was moved to
+	}
+
+	//with errors ignored, a failed allocation must give an empty pointer
+	void IgnoredErrorsGiveEmpty()
+	{
+		ObjectPool<int> pool;
+		pool.set_limit(1);
+		auto const first = pool.make_unique(1);
+		CTOOLHU_CHECK(first && *first == 1);
+		CTOOLHU_CHECK(!pool.make_unique(2));
+		CTOOLHU_CHECK(!pool.make_pooled(3));
+		CTOOLHU_CHECK(pool.stats().live == 1);
+	}
+
+	//free chunks of objects less aligned than a pointer must still hold the free list link aligned
+	void UnalignedObjects()
+	{
+		using object_t = std::array<char, 9>;
+		ObjectPool<object_t> pool;
+		std::vector<ObjectPool<object_t>::unique_ptr_t> objects;
+		for (int i{0}; i < 100; ++i)
+			objects.push_back(pool.make_unique());
+
+		for (auto const &obj : objects)
+			CTOOLHU_CHECK(reinterpret_cast<std::uintptr_t>(obj.get()) % alignof(void *) == 0);
+
+		objects.clear();
+		CTOOLHU_CHECK(pool.make_unique());
+	}
+
+	//throws from the constructor when asked to
+	struct Throwing {
+		explicit Throwing(bool fail)
+		{
+			if (fail)
+				throw std::runtime_error{"construction failed"};
+			++alive;
+		}
+		~Throwing() { --alive; }
+		static inline int alive{0};
+	};
+
+	//the chunk of an object whose constructor throws must be freed and the object never destroyed
+	template <class Pool>
+	void ThrowingConstructor(Pool &pool)
+	{
+		auto const kept = pool.make_unique(false);
+		try {
+			pool.make_unique(true);
+			CTOOLHU_CHECK(false);
+		}
+		catch (const std::runtime_error &) {}
+		CTOOLHU_CHECK(Throwing::alive == 1);
+	}
+
+	void ThrowingConstructorFreed()
+	{
+		{
+			ObjectPool<Throwing> pool;
+			ThrowingConstructor(pool);
+			try {
+				pool.make_pooled(true);
+			}
+			catch (const std::runtime_error &) {}
+			CTOOLHU_CHECK(pool.stats().live == 0);
+		}
+		CTOOLHU_CHECK(Throwing::alive == 0);
+		{
+			ConcurrentObjectPool<Throwing> pool;
+			ThrowingConstructor(pool);
+			CTOOLHU_CHECK(pool.stats().live == 0);
+		}
+		CTOOLHU_CHECK(Throwing::alive == 0);
+	}
+
+} //ns
+
+int main()
+{
+	LimitBelowLive();
+	IgnoredErrorsGiveEmpty();
+	UnalignedObjects();
+	ThrowingConstructorFreed();
+	SharedOutlivesPool();
+	MovedFromPool();
+	ConcurrentPoolDestroysLive();
+	ConcurrentPoolRegistered();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,73 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+// Tests of the random generators.
+
+#include "check.hpp"
+#include <ctoolhu/random/generator.hpp>
+#include <ctoolhu/random/philox.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	using namespace Ctoolhu::Random;
+
+	//fills from a new engine of given key and stream, in a thread of its own
+	template <class Distribution, class Boundary>
+	std::vector<typename Distribution::result_type> FillStream(std::uint64_t key, std::uint64_t stream, Boundary lower, Boundary upper)
+	{
+		std::vector<typename Distribution::result_type> values(1000);
+		std::thread{[&] {
+			Philox4x32 engine{key, stream};
+			Generator<Distribution, Boundary, Philox4x32>{engine, lower, upper}.fill(values);
+		}}.join();
+		return values;
+	}
+
+	//a generator over given engine must fill the same values from the same key and stream, in whatever thread
+	void FillReproducible()
+	{
+		using int_dist_t = std::uniform_int_distribution<>;
+		auto const ints = FillStream<int_dist_t>(7, 3, 1, 1000);
+		CTOOLHU_CHECK(ints == FillStream<int_dist_t>(7, 3, 1, 1000));
+		CTOOLHU_CHECK(ints != FillStream<int_dist_t>(7, 4, 1, 1000));
+
+		using real_dist_t = std::uniform_real_distribution<double>;
+		CTOOLHU_CHECK((FillStream<real_dist_t>(7, 3, 0.0, 1.0) == FillStream<real_dist_t>(7, 3, 0.0, 1.0)));
+	}
+
+	//engine drawing the maximal word only
+	struct MaxEngine {
+		using result_type = std::uint64_t;
+		static constexpr result_type min() noexcept { return 0; }
+		static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+		result_type operator()() noexcept { return max(); }
+	};
+
+	//the upper bound of a real range is excluded even where the values round up to it
+	void FillExcludesUpper()
+	{
+		MaxEngine engine;
+		std::vector<float> floats(10);
+		fill_uniform(engine, std::span{floats}, 1.0f, 2.0f);
+		CTOOLHU_CHECK(std::all_of(floats.begin(), floats.end(), [](float v) { return v >= 1.0f && v < 2.0f; }));
+
+		std::vector<double> doubles(10);
+		fill_uniform(engine, std::span{doubles}, -1.0, 1.0);
+		CTOOLHU_CHECK(std::all_of(doubles.begin(), doubles.end(), [](double v) { return v >= -1.0 && v < 1.0; }));
+	}
+
+} //ns
+
+int main()
+{
+	FillReproducible();
+	FillExcludesUpper();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,83 @@
+//----------------------------------------------------------------------------
+// Author:		Martin Klemsa
+//----------------------------------------------------------------------------
+// Tests of the profiler.
+
+#define CTOOLHU_PROFILE
+#include "check.hpp"
+#include <ctoolhu/time/profiler.hpp>
+#include <cstdint>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+	using namespace Ctoolhu::Time;
+
+	std::uint64_t ZoneCount(const ProfileNode &node)
+	{
+		auto count = node.count;
+		for (auto const &child : node.children)
+			count += ZoneCount(child);
+
+		return count;
+	}
+
+	std::size_t LogCount()
+	{
+		std::size_t count{0};
+		Private::SingleProfileRegistry::Instance().ForEachLog([&count](const Private::ZoneLog &) { ++count; });
+		return count;
+	}
+
+	//the zones of ended threads are reported until a reset, which then frees their logs
+	void ResetFreesEndedThreads()
+	{
+		ResetProfile();
+		for (int t{0}; t < 4; ++t) {
+			std::thread{[] {
+				for (int i{0}; i < 10'000; ++i)
+					CTOOLHU_PROFILE_SCOPE("zone");
+			}}.join();
+		}
+		CTOOLHU_CHECK(ZoneCount(ProfileTree()) == 40'000);
+		CTOOLHU_CHECK(LogCount() == 4);
+
+		ResetProfile();
+		CTOOLHU_CHECK(ZoneCount(ProfileTree()) == 0);
+		CTOOLHU_CHECK(LogCount() == 0);
+	}
+
+	//a reset in the middle of a chunk keeps reporting only the zones recorded after it
+	void ResetKeepsLaterZones()
+	{
+		for (int i{0}; i < 10'000; ++i)
+			CTOOLHU_PROFILE_SCOPE("before");
+
+		ResetProfile();
+		for (int i{0}; i < 5; ++i)
+			CTOOLHU_PROFILE_SCOPE("after");
+
+		auto const tree = ProfileTree();
+		CTOOLHU_CHECK(tree.children.size() == 1 && tree.children[0].name == "after" && tree.children[0].count == 5);
+	}
+
+	//writing the trace leaves the formatting of the caller's stream as it was
+	void ChromeTraceKeepsFormat()
+	{
+		CTOOLHU_PROFILE_SCOPE("zone");
+		std::ostringstream out;
+		out.precision(2);
+		WriteChromeTrace(out);
+		CTOOLHU_CHECK(!(out.flags() & std::ios::fixed) && out.precision() == 2);
+	}
+
+} //ns
+
+int main()
+{
+	ResetFreesEndedThreads();
+	ResetKeepsLaterZones();
+	ChromeTraceKeepsFormat();
+	return EXIT_SUCCESS;
+}